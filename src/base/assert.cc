@@ -0,0 +1,23 @@
+#include <base/assert.hh>
+
+#include <base/crash.hh>
+
+#include <base/using_log.hh>
+
+namespace shinobi {
+
+Log CheckFailed(const char* expr, const char* file, int line) {
+  void* frames[Crash::kMaxFrames];
+  const ui32 depth = Crash::CaptureStack(frames, Crash::kMaxFrames);
+
+  Log log(ASSERT);
+  log << "Assertion failed: " << expr << " at " << file << ":" << line
+      << std::endl;
+  // Skip the frame of this function.
+  for (ui32 i = 1; i < depth; ++i) {
+    log << "  " << Crash::Symbolize(frames[i]) << std::endl;
+  }
+  return log;
+}
+
+}  // namespace shinobi
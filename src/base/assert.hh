@@ -7,22 +7,19 @@
 #include STL(sstream)
 
 namespace shinobi {
-void GetStackTrace(ui8 depth, Vector<String>& strings);
+
+// The failure path of |CHECK()| is cold and out of line - so the checks don't
+// bloat the hot code. The returned log aborts the program on destruction.
+__attribute__((cold, noinline)) Log CheckFailed(const char* expr,
+                                                const char* file, int line);
+
 }  // namespace shinobi
 
-#define CHECK(expr)                                    \
-  if (!(expr))                                         \
-  [] {                                                 \
-    using namespace shinobi;                           \
-    Vector<String> strings;                            \
-    Log log(named_levels::ASSERT);                     \
-    GetStackTrace(62, strings);                        \
-    log << "Assertion failed: " << #expr << std::endl; \
-    for (size_t i = 1; i < strings.size(); ++i) {      \
-      log << "  " << strings[i] << std::endl;          \
-    }                                                  \
-    return log;                                        \
-  }()
+#define CHECK(expr)                                         \
+  __builtin_expect(!!(expr), 1)                             \
+      ? (void)0                                             \
+      : shinobi::Log::Voidify() &                           \
+            shinobi::CheckFailed(#expr, __FILE__, __LINE__)
 
 // There is a trick how to use lambda in expression:
 //
@@ -39,3 +36,11 @@ void GetStackTrace(ui8 depth, Vector<String>& strings);
 #define DCHECK(expr) CHECK(expr)
 #define NOTREACHED() DCHECK(false) << "NOTREACHED"
 #endif
+
+// The checks on hot paths, like the node accessors. Release builds downgrade
+// them to |DCHECK()|, unless configured with "config_hot_checks = true".
+#if defined(DISABLE_HOT_CHECKS)
+#define HOT_CHECK(expr) DCHECK(expr)
+#else
+#define HOT_CHECK(expr) CHECK(expr)
+#endif
@@ -0,0 +1,28 @@
+#include <base/assert.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+namespace shinobi {
+
+namespace {
+
+int Count(int& counter) {
+  return ++counter;
+}
+
+}  // namespace
+
+TEST(AssertTest, PassedCheckDoesNotEvaluateMessage) {
+  int counter = 0;
+  CHECK(counter == 0) << Count(counter);
+  EXPECT_EQ(0, counter);
+}
+
+TEST(AssertTest, FailedCheckAborts) {
+  EXPECT_DEATH(CHECK(1 + 1 == 3) << "custom message",
+               "Assertion failed: 1 \\+ 1 == 3 at .*assert_test.cc:[0-9]+");
+  EXPECT_DEATH(CHECK(false) << "custom message", "custom message");
+}
+
+}  // namespace shinobi
@@ -0,0 +1,298 @@
+#include <base/async_log_sink.hh>
+
+#include <base/logging.hh>
+
+#include STL(cerrno)
+#include STL(chrono)
+#include STL(cstring)
+
+#if !defined(OS_WIN)
+#include <syslog.h>
+#include <unistd.h>
+#else
+#include STL(iostream)
+#endif
+
+#include <base/using_log.hh>
+
+namespace shinobi {
+
+namespace {
+
+constexpr size_t kMaxBatchSize = 1u << 20;
+constexpr auto kDrainPeriod = std::chrono::milliseconds(10);
+
+std::atomic<ui64> next_sink_id(0);
+
+}  // namespace
+
+// Single producer - the owning thread, single consumer - whoever holds the
+// sink's mutex. Positions grow monotonically and wrap with the mask.
+class AsyncLogSink::Ring {
+ public:
+  struct Header {
+    ui32 size;
+    ui32 level;
+    Destination destination;
+  };
+
+  explicit Ring(ui32 size) : buffer_(size) {}
+
+  bool Write(const Header& header, const char* data) {
+    const ui64 total = sizeof(header) + header.size;
+    const ui64 head = head_.load(std::memory_order_relaxed);
+
+    if (head + total - cached_tail_ > buffer_.size()) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head + total - cached_tail_ > buffer_.size()) {
+        // Only the producer modifies the counter - no need for RMW.
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        return false;
+      }
+    }
+
+    CopyIn(head, reinterpret_cast<const char*>(&header), sizeof(header));
+    CopyIn(head + sizeof(header), data, header.size);
+    head_.store(head + total, std::memory_order_release);
+    return true;
+  }
+
+  // Calls |callback(header, text)| for each available record.
+  template <class Callback>
+  void Read(Callback&& callback) {
+    const ui64 head = head_.load(std::memory_order_acquire);
+    ui64 tail = tail_.load(std::memory_order_relaxed);
+
+    Header header;
+    String text;
+    while (tail < head) {
+      CopyOut(tail, reinterpret_cast<char*>(&header), sizeof(header));
+      tail += sizeof(header);
+      text.resize(header.size);
+      CopyOut(tail, &text[0], header.size);
+      tail += header.size;
+
+      callback(header, text);
+    }
+
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  inline void Close() { closed_.store(true, std::memory_order_release); }
+  inline bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  inline ui64 dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void CopyIn(ui64 position, const char* data, size_t size) {
+    const size_t offset = position & (buffer_.size() - 1);
+    const size_t first = std::min(size, buffer_.size() - offset);
+    std::memcpy(&buffer_[offset], data, first);
+    std::memcpy(&buffer_[0], data + first, size - first);
+  }
+
+  void CopyOut(ui64 position, char* data, size_t size) const {
+    const size_t offset = position & (buffer_.size() - 1);
+    const size_t first = std::min(size, buffer_.size() - offset);
+    std::memcpy(data, &buffer_[offset], first);
+    std::memcpy(data + first, &buffer_[0], size - first);
+  }
+
+  Vector<char> buffer_;
+
+  alignas(64) std::atomic<ui64> head_{0};
+  ui64 cached_tail_ = 0;  // Producer's last seen |tail_|.
+  std::atomic<ui64> dropped_{0};
+  std::atomic<bool> closed_{false};
+
+  alignas(64) std::atomic<ui64> tail_{0};
+};
+
+// Rings of the current thread, keyed by sink id. They are closed on thread
+// exit, so the sink may reclaim them after the final drain.
+struct AsyncLogSink::ThreadRings {
+  ~ThreadRings() {
+    for (auto& ring : rings) {
+      ring.second->Close();
+    }
+  }
+
+  Vector<Pair<ui64, SharedPtr<Ring>>> rings;
+};
+
+AsyncLogSink::AsyncLogSink(ui32 ring_size, Output output)
+    : id_(next_sink_id++),
+      ring_size_([ring_size] {
+        ui32 size = 1024;
+        while (size < ring_size) {
+          size <<= 1;
+        }
+        return size;
+      }()),
+      output_(output ? std::move(output) : Output(&AsyncLogSink::Write)),
+      thread_(&AsyncLogSink::Run, this) {}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  condition_.notify_one();
+  thread_.join();
+}
+
+bool AsyncLogSink::Push(Destination destination, ui32 level,
+                        const String& text) {
+  return GetRing()->Write(
+      Ring::Header{static_cast<ui32>(text.size()), level, destination},
+      text.data());
+}
+
+void AsyncLogSink::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Drain();
+}
+
+ui64 AsyncLogSink::dropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ui64 dropped = orphans_dropped_;
+  for (const auto& ring : rings_) {
+    dropped += ring->dropped();
+  }
+  return dropped;
+}
+
+void AsyncLogSink::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!shutdown_) {
+    condition_.wait_for(lock, kDrainPeriod);
+    Drain();
+  }
+  Drain();
+}
+
+void AsyncLogSink::Drain() {
+  Destination batch_destination = STDOUT;
+
+  auto flush_batch = [&] {
+    if (!batch_.empty()) {
+      output_(batch_destination, INFO, batch_);
+      batch_.clear();
+    }
+  };
+
+  ui64 dropped = orphans_dropped_;
+
+  for (auto it = rings_.begin(); it != rings_.end();) {
+    Ring& ring = **it;
+    // Check before reading: the records pushed prior to closing are visible.
+    const bool closed = ring.closed();
+
+    ring.Read([&](const Ring::Header& header, String& text) {
+      if (header.destination == SYSLOG) {
+        flush_batch();
+        output_(SYSLOG, header.level, text);
+        return;
+      }
+
+      if (header.destination != batch_destination ||
+          batch_.size() + text.size() > kMaxBatchSize) {
+        flush_batch();
+        batch_destination = header.destination;
+      }
+      batch_ += text;
+    });
+
+    dropped += ring.dropped();
+    if (closed) {
+      orphans_dropped_ += ring.dropped();
+      it = rings_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (dropped > reported_dropped_) {
+    if (batch_destination != STDERR) {
+      flush_batch();
+      batch_destination = STDERR;
+    }
+    batch_ += std::to_string(dropped - reported_dropped_) +
+              " log records dropped\n";
+    reported_dropped_ = dropped;
+  }
+
+  flush_batch();
+}
+
+AsyncLogSink::Ring* AsyncLogSink::GetRing() {
+  static thread_local ThreadRings thread_rings;
+
+  for (const auto& ring : thread_rings.rings) {
+    if (ring.first == id_) {
+      return ring.second.get();
+    }
+  }
+
+  auto ring = std::make_shared<Ring>(ring_size_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings_.push_back(ring);
+  }
+  thread_rings.rings.emplace_back(id_, ring);
+  return ring.get();
+}
+
+// static
+void AsyncLogSink::Write(Destination destination, ui32 level,
+                         const String& text) {
+#if !defined(OS_WIN)
+  if (destination == SYSLOG) {
+    // FIXME: not really a fair mapping.
+    switch (level) {
+      case FATAL:
+      case ASSERT:
+        syslog(LOG_CRIT, "%s", text.c_str());
+        break;
+
+      case ERROR:
+        syslog(LOG_ERR, "%s", text.c_str());
+        break;
+
+      case WARNING:
+        syslog(LOG_WARNING, "%s", text.c_str());
+        break;
+
+      case INFO:
+        syslog(LOG_NOTICE, "%s", text.c_str());
+        break;
+
+      default:
+        syslog(LOG_INFO, "%s", text.c_str());
+    }
+    return;
+  }
+
+  const int fd = destination == STDERR ? STDERR_FILENO : STDOUT_FILENO;
+  const char* data = text.data();
+  size_t size = text.size();
+  while (size > 0) {
+    const ssize_t written = write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    data += written;
+    size -= written;
+  }
+#else
+  (destination == STDERR ? std::cerr : std::cout) << text << std::flush;
+#endif  // !defined(OS_WIN)
+}
+
+}  // namespace shinobi
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/attributes.hh>
+
+#include STL(atomic)
+#include STL(condition_variable)
+#include STL(functional)
+#include STL(mutex)
+#include STL(thread)
+
+namespace shinobi {
+
+// Each producing thread appends formatted records to its own lock-free SPSC
+// ring, and the background thread drains all rings, merging the consecutive
+// console records into large writes. The memory is bounded by the ring size
+// per thread: when a ring is full, the new records are dropped and counted.
+class AsyncLogSink {
+ public:
+  enum Destination : ui32 {
+    STDOUT,
+    STDERR,
+    SYSLOG,
+  };
+
+  // For console destinations |text| may hold several records. For |SYSLOG|
+  // it's always a single record of |level|.
+  using Output = std::function<void(Destination destination, ui32 level,
+                                    const String& text)>;
+
+  // |ring_size| is rounded up to the power of two.
+  explicit AsyncLogSink(ui32 ring_size = 1u << 16, Output output = Output());
+  ~AsyncLogSink();  // Flushes all pushed records.
+
+  AsyncLogSink(const AsyncLogSink&) = delete;
+  AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+  // Returns false, if the record doesn't fit into the ring and is dropped.
+  THREAD_SAFE bool Push(Destination destination, ui32 level,
+                        const String& text);
+
+  // Returns after all records, pushed before the call, are written out.
+  THREAD_SAFE void Flush();
+
+  THREAD_SAFE ui64 dropped() const;
+
+  // Writes synchronously - it's the default output.
+  static void Write(Destination destination, ui32 level,
+                    const String& text);
+
+ private:
+  class Ring;
+
+  struct ThreadRings;
+
+  void Run();
+  void Drain();  // Should be called with |mutex_| locked.
+  Ring* GetRing();
+
+  const ui64 id_;
+  const ui32 ring_size_;
+  const Output output_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  bool shutdown_ = false;
+  List<SharedPtr<Ring>> rings_;
+  ui64 reported_dropped_ = 0;
+  ui64 orphans_dropped_ = 0;  // Dropped by rings of already finished threads.
+  String batch_;
+
+  std::thread thread_;
+};
+
+}  // namespace shinobi
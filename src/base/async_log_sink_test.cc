@@ -0,0 +1,86 @@
+#include <base/async_log_sink.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+namespace shinobi {
+
+namespace {
+
+struct Collector {
+  void operator()(AsyncLogSink::Destination destination, ui32,
+                  const String& text) {
+    std::lock_guard<std::mutex> lock(mutex);
+    outputs[destination] += text;
+    ++writes;
+  }
+
+  std::mutex mutex;
+  Map<ui32, String> outputs;
+  ui32 writes = 0;
+};
+
+}  // namespace
+
+TEST(AsyncLogSinkTest, KeepsOrderOfEachThread) {
+  Collector collector;
+  {
+    AsyncLogSink sink(1u << 12, std::ref(collector));
+
+    Vector<std::thread> threads;
+    for (ui32 t = 0; t < 4; ++t) {
+      threads.emplace_back([&sink, t] {
+        for (ui32 i = 0; i < 1000;) {
+          const String text =
+              std::to_string(t) + ":" + std::to_string(i) + "\n";
+          // Retry on overflow - for the sake of the test.
+          if (sink.Push(AsyncLogSink::STDOUT, 0, text)) {
+            ++i;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  Vector<i64> last(4, -1);
+  const String& output = collector.outputs[AsyncLogSink::STDOUT];
+  size_t begin = 0, records = 0;
+  while (begin < output.size()) {
+    const size_t colon = output.find(':', begin);
+    const size_t end = output.find('\n', colon);
+    ASSERT_NE(String::npos, end);
+
+    const ui32 thread = std::stoul(output.substr(begin, colon - begin));
+    const i64 index = std::stoll(output.substr(colon + 1, end - colon - 1));
+    ASSERT_LT(thread, 4u);
+    EXPECT_EQ(last[thread] + 1, index);
+    last[thread] = index;
+
+    begin = end + 1;
+    ++records;
+  }
+  EXPECT_EQ(4000u, records);
+  EXPECT_LT(collector.writes, records);  // Records are written in batches.
+}
+
+TEST(AsyncLogSinkTest, DropsOnOverflow) {
+  Collector collector;
+  AsyncLogSink sink(1024, std::ref(collector));
+
+  EXPECT_FALSE(sink.Push(AsyncLogSink::STDOUT, 0, String(2048, 'x')));
+  EXPECT_TRUE(sink.Push(AsyncLogSink::STDOUT, 0, "fits\n"));
+  EXPECT_EQ(1u, sink.dropped());
+
+  sink.Flush();
+  std::lock_guard<std::mutex> lock(collector.mutex);
+  EXPECT_EQ("fits\n", collector.outputs[AsyncLogSink::STDOUT]);
+  EXPECT_EQ("1 log records dropped\n",
+            collector.outputs[AsyncLogSink::STDERR]);
+}
+
+}  // namespace shinobi
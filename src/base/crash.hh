@@ -0,0 +1,57 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/attributes.hh>
+#include <base/path.hh>
+
+#include STL(iosfwd)
+
+namespace shinobi {
+
+// Reports the fatal signals without allocating memory or taking locks - only
+// the raw return addresses are written, together with the loaded modules.
+// The report is symbolized later: in-process with |Symbolize()|, or by a
+// later run of the same binary, or with "addr2line -e <module> <offset>".
+//
+// The report looks like:
+//
+//   *** shinobi crash: SIGSEGV, thread 1234
+//   module 0 0x55d0c8a4e000 /path/to/shinobi
+//   frame 0 0x55d0c8a5f2a4 0 +0x112a4
+//   ...
+//   *** end
+//
+// The concurrent crashes are serialized, so each report stays readable.
+class Crash {
+ public:
+  static constexpr ui32 kMaxFrames = 64;
+
+  // Preallocates everything and installs the handlers of the fatal signals on
+  // an alternate stack. The reports are appended to |path|, or written to
+  // stderr if it's empty. Returns false, if the file can't be opened.
+  THREAD_UNSAFE static bool Install(const Path& path = Path());
+
+  // Sets up the alternate signal stack for the current thread - so the stack
+  // overflows are reported too. Should be called by each long-living thread.
+  THREAD_SAFE static void PrepareThread();
+
+  // Captures up to |max_depth| return addresses, skipping the frame of this
+  // function. Async-signal-safe after |Install()|.
+  THREAD_SAFE static ui32 CaptureStack(void** frames, ui32 max_depth);
+
+  // Writes the report of the captured frames. Async-signal-safe.
+  THREAD_SAFE static void WriteReport(const char* reason, void* const* frames,
+                                      ui32 depth);
+
+  // Returns the demangled "function+0x10 (module)" of the return address. The
+  // results are cached, so the repeating frames are demangled once.
+  THREAD_SAFE static String Symbolize(const void* address);
+
+  // Symbolizes the report written by the same binary - possibly by another
+  // process. The frames of unknown modules are left as "module+0x10".
+  // Returns false, if there are no reports in the input.
+  THREAD_SAFE static bool Symbolize(std::istream& report,
+                                    std::ostream& output);
+};
+
+}  // namespace shinobi
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <base/aliases.hh>
+
+#include <limits.h>
+#include <stdint.h>
+
+// The platform-specific parts of |Crash|.
+namespace shinobi::internal {
+
+struct Module {
+  uintptr_t base, begin, end;
+  char path[PATH_MAX];
+};
+
+// Fills up to |max_count| modules of the process: the executable and the
+// loaded libraries. Returns their number.
+ui32 CollectModules(Module* modules, ui32 max_count);
+
+// Async-signal-safe.
+ui64 CurrentThreadId();
+
+// The load addresses of the modules of this process - by path.
+Map<String, uintptr_t> ModuleBases();
+
+}  // namespace shinobi::internal
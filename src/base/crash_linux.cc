@@ -0,0 +1,86 @@
+#include <base/crash_internal.hh>
+
+#include STL(algorithm)
+
+#include <link.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace shinobi::internal {
+
+namespace {
+
+struct Modules {
+  Module* modules;
+  ui32 max_count, count;
+};
+
+// The main executable has an empty name in the loader's list.
+void ExecutablePath(char* path, size_t size) {
+  const ssize_t length = readlink("/proc/self/exe", path, size - 1);
+  path[length > 0 ? length : 0] = '\0';
+}
+
+void ModulePath(const dl_phdr_info* info, char* path, size_t size) {
+  if (info->dlpi_name && info->dlpi_name[0]) {
+    strncpy(path, info->dlpi_name, size - 1);
+    path[size - 1] = '\0';
+  } else {
+    ExecutablePath(path, size);
+  }
+}
+
+int CollectModule(dl_phdr_info* info, size_t, void* data) {
+  auto& modules = *static_cast<Modules*>(data);
+  if (modules.count == modules.max_count) {
+    return 1;
+  }
+
+  Module& module = modules.modules[modules.count];
+  module.base = info->dlpi_addr;
+  module.begin = UINTPTR_MAX;
+  module.end = 0;
+  for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+    const auto& header = info->dlpi_phdr[i];
+    if (header.p_type == PT_LOAD) {
+      const uintptr_t begin = info->dlpi_addr + header.p_vaddr;
+      module.begin = std::min(module.begin, begin);
+      module.end = std::max(module.end, begin + header.p_memsz);
+    }
+  }
+  if (module.begin >= module.end) {
+    return 0;
+  }
+
+  ModulePath(info, module.path, sizeof(module.path));
+  ++modules.count;
+  return 0;
+}
+
+}  // namespace
+
+ui32 CollectModules(Module* modules, ui32 max_count) {
+  Modules result = {modules, max_count, 0};
+  dl_iterate_phdr(CollectModule, &result);
+  return result.count;
+}
+
+ui64 CurrentThreadId() {
+  return syscall(SYS_gettid);
+}
+
+Map<String, uintptr_t> ModuleBases() {
+  Map<String, uintptr_t> bases;
+  dl_iterate_phdr(
+      [](dl_phdr_info* info, size_t, void* data) {
+        char path[PATH_MAX];
+        ModulePath(info, path, sizeof(path));
+        (*static_cast<Map<String, uintptr_t>*>(data))[path] = info->dlpi_addr;
+        return 0;
+      },
+      &bases);
+  return bases;
+}
+
+}  // namespace shinobi::internal
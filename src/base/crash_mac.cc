@@ -0,0 +1,71 @@
+#include <base/crash_internal.hh>
+
+#include STL(algorithm)
+
+#include <mach-o/dyld.h>
+#include <mach-o/loader.h>
+#include <pthread.h>
+#include <string.h>
+
+namespace shinobi::internal {
+
+ui32 CollectModules(Module* modules, ui32 max_count) {
+  ui32 count = 0;
+  const uint32_t images = _dyld_image_count();
+  for (uint32_t i = 0; i < images && count < max_count; ++i) {
+    const auto* header =
+        reinterpret_cast<const mach_header_64*>(_dyld_get_image_header(i));
+    const char* name = _dyld_get_image_name(i);
+    if (!header || header->magic != MH_MAGIC_64 || !name) {
+      continue;
+    }
+
+    Module& module = modules[count];
+    module.base = _dyld_get_image_vmaddr_slide(i);
+    module.begin = UINTPTR_MAX;
+    module.end = 0;
+
+    // The segments follow the header. The zero page isn't mapped.
+    const auto* command = reinterpret_cast<const load_command*>(header + 1);
+    for (uint32_t j = 0; j < header->ncmds; ++j) {
+      if (command->cmd == LC_SEGMENT_64) {
+        const auto* segment =
+            reinterpret_cast<const segment_command_64*>(command);
+        if (segment->vmsize && strcmp(segment->segname, SEG_PAGEZERO) != 0) {
+          const uintptr_t begin = module.base + segment->vmaddr;
+          module.begin = std::min(module.begin, begin);
+          module.end = std::max<uintptr_t>(module.end, begin + segment->vmsize);
+        }
+      }
+      command = reinterpret_cast<const load_command*>(
+          reinterpret_cast<const char*>(command) + command->cmdsize);
+    }
+    if (module.begin >= module.end) {
+      continue;
+    }
+
+    strncpy(module.path, name, sizeof(module.path) - 1);
+    module.path[sizeof(module.path) - 1] = '\0';
+    ++count;
+  }
+  return count;
+}
+
+ui64 CurrentThreadId() {
+  uint64_t id = 0;
+  pthread_threadid_np(nullptr, &id);
+  return id;
+}
+
+Map<String, uintptr_t> ModuleBases() {
+  Map<String, uintptr_t> bases;
+  const uint32_t images = _dyld_image_count();
+  for (uint32_t i = 0; i < images; ++i) {
+    if (const char* name = _dyld_get_image_name(i)) {
+      bases[name] = _dyld_get_image_vmaddr_slide(i);
+    }
+  }
+  return bases;
+}
+
+}  // namespace shinobi::internal
@@ -0,0 +1,373 @@
+#include <base/crash.hh>
+#include <base/crash_internal.hh>
+
+#include STL(algorithm)
+#include STL(atomic)
+#include STL(cxxabi.h)
+#include STL(istream)
+#include STL(mutex)
+#include STL(ostream)
+#include STL(sstream)
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace shinobi {
+
+namespace {
+
+using internal::Module;
+
+constexpr ui32 kMaxModules = 64;
+constexpr size_t kAltStackSize = 64 * 1024;
+
+// Everything the signal handler touches is allocated in advance.
+int report_fd = STDERR_FILENO;
+Module modules[kMaxModules];
+ui32 module_count = 0;
+std::atomic<ui64> report_owner(0);
+
+constexpr int kSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+const char* SignalName(int signal) {
+  switch (signal) {
+    case SIGSEGV:
+      return "SIGSEGV";
+    case SIGBUS:
+      return "SIGBUS";
+    case SIGFPE:
+      return "SIGFPE";
+    case SIGILL:
+      return "SIGILL";
+    case SIGABRT:
+      return "SIGABRT";
+  }
+  return "signal";
+}
+
+// Formats a line of the report in a fixed buffer - no allocations.
+class Line {
+ public:
+  Line& operator<<(const char* string) {
+    while (*string && size_ < sizeof(buffer_)) {
+      buffer_[size_++] = *string++;
+    }
+    return *this;
+  }
+
+  Line& Decimal(ui64 value) {
+    char digits[20];
+    ui32 count = 0;
+    do {
+      digits[count++] = '0' + value % 10;
+      value /= 10;
+    } while (value);
+    while (count && size_ < sizeof(buffer_)) {
+      buffer_[size_++] = digits[--count];
+    }
+    return *this;
+  }
+
+  Line& Hex(ui64 value) {
+    char digits[16];
+    ui32 count = 0;
+    do {
+      digits[count++] = "0123456789abcdef"[value % 16];
+      value /= 16;
+    } while (value);
+    *this << "0x";
+    while (count && size_ < sizeof(buffer_)) {
+      buffer_[size_++] = digits[--count];
+    }
+    return *this;
+  }
+
+  void Write(int fd) {
+    if (size_ == sizeof(buffer_)) {
+      buffer_[size_ - 1] = '\n';
+    }
+
+    const char* data = buffer_;
+    while (size_) {
+      const ssize_t written = write(fd, data, size_);
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written <= 0) {
+        break;
+      }
+      data += written;
+      size_ -= written;
+    }
+    size_ = 0;
+  }
+
+ private:
+  char buffer_[PATH_MAX + 64];
+  size_t size_ = 0;
+};
+
+i32 FindModule(uintptr_t address) {
+  for (ui32 i = 0; i < module_count; ++i) {
+    if (address >= modules[i].begin && address < modules[i].end) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void HandleSignal(int signal, siginfo_t*, void*) {
+  void* frames[Crash::kMaxFrames];
+  const ui32 depth = Crash::CaptureStack(frames, Crash::kMaxFrames);
+  Crash::WriteReport(SignalName(signal), frames, depth);
+
+  // Let the default action terminate the process - as soon as the handler
+  // returns.
+  ::signal(signal, SIG_DFL);
+  raise(signal);
+}
+
+// Disables the alternate stack before freeing it on the thread's exit.
+struct AltStack {
+  AltStack() : memory(new char[kAltStackSize]) {
+    stack_t stack = {};
+    stack.ss_sp = memory.get();
+    stack.ss_size = kAltStackSize;
+    sigaltstack(&stack, nullptr);
+  }
+
+  ~AltStack() {
+    stack_t stack = {};
+    stack.ss_flags = SS_DISABLE;
+    sigaltstack(&stack, nullptr);
+  }
+
+  UniquePtr<char[]> memory;
+};
+
+String Demangle(const char* mangled_name) {
+  int status;
+  char* demangled_name =
+      abi::__cxa_demangle(mangled_name, nullptr, nullptr, &status);
+  if (status != 0) {
+    free(demangled_name);
+    return mangled_name;
+  }
+
+  String result = demangled_name;
+  free(demangled_name);
+  return result;
+}
+
+String SymbolizeSlow(const void* address) {
+  std::stringstream result;
+
+  // A return address may point past the end of the calling function.
+  Dl_info info;
+  if (!dladdr(static_cast<const char*>(address) - 1, &info)) {
+    result << address;
+    return result.str();
+  }
+
+  const auto offset = [address](const void* base) {
+    return reinterpret_cast<uintptr_t>(address) -
+           reinterpret_cast<uintptr_t>(base);
+  };
+
+  String module = info.dli_fname ? info.dli_fname : String();
+  module = module.substr(module.rfind('/') + 1);
+  if (info.dli_sname) {
+    result << Demangle(info.dli_sname) << "+0x" << std::hex
+           << offset(info.dli_saddr) << " (" << module << ")";
+  } else {
+    result << module << "+0x" << std::hex << offset(info.dli_fbase);
+  }
+  return result.str();
+}
+
+}  // namespace
+
+// static
+bool Crash::Install(const Path& path) {
+  if (!path.empty()) {
+    const int fd =
+        open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      return false;
+    }
+    report_fd = fd;
+  }
+
+  module_count = internal::CollectModules(modules, kMaxModules);
+
+  // The first call of |backtrace()| loads the unwinder - that allocates.
+  void* frames[2];
+  backtrace(frames, 2);
+
+  PrepareThread();
+
+  struct sigaction action = {};
+  action.sa_sigaction = HandleSignal;
+  action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+  for (int signal : kSignals) {
+    sigaction(signal, &action, nullptr);
+  }
+
+  return true;
+}
+
+// static
+void Crash::PrepareThread() {
+  static thread_local UniquePtr<AltStack> stack;
+  if (!stack) {
+    stack = std::make_unique<AltStack>();
+  }
+}
+
+// static
+ui32 Crash::CaptureStack(void** frames, ui32 max_depth) {
+  void* buffer[kMaxFrames + 1];
+  max_depth = std::min(max_depth, kMaxFrames);
+
+  const int size = backtrace(buffer, max_depth + 1);
+  for (int i = 1; i < size; ++i) {
+    frames[i - 1] = buffer[i];
+  }
+  return size > 0 ? size - 1 : 0;
+}
+
+// static
+void Crash::WriteReport(const char* reason, void* const* frames, ui32 depth) {
+  const ui64 self = internal::CurrentThreadId();
+
+  // Serialize the concurrent reports. Don't wait for ourselves - if the
+  // reporting itself crashed.
+  ui64 owner = 0;
+  while (!report_owner.compare_exchange_strong(owner, self)) {
+    if (owner == self) {
+      return;
+    }
+    owner = 0;
+
+    const timespec delay = {0, 1000000};
+    nanosleep(&delay, nullptr);
+  }
+
+  Line line;
+  (line << "*** shinobi crash: " << reason << ", thread ").Decimal(self)
+      << "\n";
+  line.Write(report_fd);
+
+  bool reported[kMaxModules] = {};
+  for (ui32 i = 0; i < depth; ++i) {
+    const auto address = reinterpret_cast<uintptr_t>(frames[i]);
+    const i32 index = FindModule(address);
+    if (index >= 0 && !reported[index]) {
+      reported[index] = true;
+      (line << "module ").Decimal(index) << " ";
+      line.Hex(modules[index].base) << " " << modules[index].path << "\n";
+      line.Write(report_fd);
+    }
+
+    (line << "frame ").Decimal(i) << " ";
+    line.Hex(address) << " ";
+    if (index >= 0) {
+      line.Decimal(index) << " +";
+      line.Hex(address - modules[index].base) << "\n";
+    } else {
+      line << "- +0x0\n";
+    }
+    line.Write(report_fd);
+  }
+
+  line << "*** end\n";
+  line.Write(report_fd);
+
+  report_owner.store(0);
+}
+
+// static
+String Crash::Symbolize(const void* address) {
+  static std::mutex mutex;
+  static Map<const void*, String> cache;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(address);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+
+  // Don't hold the lock while demangling - the other threads may still use
+  // the cached frames.
+  String symbol = SymbolizeSlow(address);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  return cache.emplace(address, std::move(symbol)).first->second;
+}
+
+// static
+bool Crash::Symbolize(std::istream& report, std::ostream& output) {
+  // The modules of this process - by path.
+  const Map<String, uintptr_t> loaded = internal::ModuleBases();
+
+  bool found = false;
+  Map<i32, String> paths;  // The modules of the current report.
+  String line;
+  while (std::getline(report, line)) {
+    std::istringstream stream(line);
+    String kind;
+    stream >> kind;
+
+    if (kind == "module") {
+      i32 index;
+      String base, path;
+      stream >> index >> base >> std::ws;
+      std::getline(stream, path);
+      paths[index] = path;
+      continue;
+    }
+
+    if (kind != "frame") {
+      if (line.compare(0, 18, "*** shinobi crash:") == 0) {
+        found = true;
+        paths.clear();
+      }
+      output << line << std::endl;
+      continue;
+    }
+
+    String number, address, module, offset;
+    stream >> number >> address >> module >> offset;
+    output << "  #" << number << " ";
+
+    auto path = paths.find(module == "-" ? -1 : std::stoi(module));
+    if (path == paths.end()) {
+      output << address << std::endl;
+      continue;
+    }
+
+    auto base = loaded.find(path->second);
+    if (base == loaded.end()) {
+      output << path->second << offset << std::endl;
+      continue;
+    }
+
+    const uintptr_t relative = std::stoull(offset.substr(1), nullptr, 16);
+    output << Symbolize(reinterpret_cast<const void*>(base->second + relative))
+           << std::endl;
+  }
+
+  return found;
+}
+
+}  // namespace shinobi
@@ -0,0 +1,129 @@
+#include <base/crash.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+#include STL(sstream)
+#include STL(thread)
+
+#include <signal.h>
+#include <unistd.h>
+
+namespace shinobi {
+
+namespace {
+
+__attribute__((noinline)) void Segfault() {
+  raise(SIGSEGV);
+}
+
+String ReadFile(const Path& path) {
+  std::ifstream stream(path);
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+ui32 Count(const String& string, const String& substring) {
+  ui32 count = 0;
+  for (auto pos = string.find(substring); pos != String::npos;
+       pos = string.find(substring, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(CrashTest, SymbolizesCapturedStack) {
+  void* frames[Crash::kMaxFrames];
+  const ui32 depth = Crash::CaptureStack(frames, Crash::kMaxFrames);
+  ASSERT_LT(0u, depth);
+
+  // The test body is called by the gtest's machinery.
+  String trace;
+  for (ui32 i = 0; i < depth; ++i) {
+    trace += Crash::Symbolize(frames[i]) + "\n";
+  }
+  EXPECT_NE(String::npos, trace.find("testing::"));
+  EXPECT_EQ(Crash::Symbolize(frames[0]), Crash::Symbolize(frames[0]));
+}
+
+TEST(CrashTest, ReportsSignal) {
+  char path[] = "/tmp/shinobi_crash_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_NE(-1, fd);
+  close(fd);
+
+  EXPECT_DEATH(
+      {
+        Crash::Install(path);
+        Segfault();
+      },
+      "");
+
+  const String report = ReadFile(path);
+  EXPECT_EQ(0u, report.find("*** shinobi crash: SIGSEGV, thread "));
+  EXPECT_NE(String::npos, report.find("\nmodule 0 0x"));
+  EXPECT_NE(String::npos, report.find("\nframe 0 0x"));
+  EXPECT_NE(String::npos, report.find("\n*** end\n"));
+
+  // The same binary is still loaded - so the frames can be symbolized.
+  std::ifstream stream(path);
+  std::stringstream output;
+  ASSERT_TRUE(Crash::Symbolize(stream, output));
+  EXPECT_NE(String::npos, output.str().find("testing::"));
+  unlink(path);
+}
+
+TEST(CrashTest, SerializesConcurrentReports) {
+  char path[] = "/tmp/shinobi_crash_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_NE(-1, fd);
+  close(fd);
+
+  EXPECT_DEATH(
+      {
+        Crash::Install(path);
+
+        // Crash in several threads at once - the reports mustn't interleave.
+        Vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+          threads.emplace_back([] {
+            Crash::PrepareThread();
+            void* frames[Crash::kMaxFrames];
+            const ui32 depth = Crash::CaptureStack(frames, Crash::kMaxFrames);
+            Crash::WriteReport("test", frames, depth);
+          });
+        }
+        for (auto& thread : threads) {
+          thread.join();
+        }
+        Segfault();
+      },
+      "");
+
+  const String report = ReadFile(path);
+  unlink(path);
+
+  EXPECT_EQ(5u, Count(report, "*** shinobi crash: "));
+  EXPECT_EQ(5u, Count(report, "*** end\n"));
+
+  std::istringstream stream(report);
+  String line;
+  bool inside = false;
+  while (std::getline(stream, line)) {
+    if (line.find("*** shinobi crash: ") == 0) {
+      EXPECT_FALSE(inside) << report;
+      inside = true;
+    } else if (line == "*** end") {
+      EXPECT_TRUE(inside) << report;
+      inside = false;
+    } else {
+      EXPECT_TRUE(inside) << report;
+    }
+  }
+}
+
+}  // namespace shinobi
@@ -0,0 +1,213 @@
+#include <base/file_system.hh>
+
+#include <base/stats.hh>
+
+#include STL(algorithm)
+#include STL(shared_mutex)
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shinobi {
+
+namespace {
+
+const Stats::Counter stat_calls("fs.stat_calls");
+const Stats::Counter stat_hits("fs.stat_hits");
+const Stats::Counter list_calls("fs.list_calls");
+const Stats::Counter list_hits("fs.list_hits");
+const Stats::Counter bytes_read("fs.bytes_read", Stats::BYTES);
+const Stats::Counter stat_time("time.fs_stat", Stats::MICROSECONDS);
+const Stats::Counter list_time("time.fs_list", Stats::MICROSECONDS);
+
+using Entries = SharedPtr<const Vector<FileSystem::Entry>>;
+
+struct Cache {
+  std::shared_mutex mutex;
+  Map<Path, FileSystem::Info> infos;
+  Map<Path, Entries> listings;  // Null, if the directory can't be listed.
+};
+
+Cache& cache() {
+  static Cache cache;
+  return cache;
+}
+
+FileSystem::Info StatSlow(const Path& path) {
+  Stats::Timer timer(stat_time);
+  stat_calls.Add();
+
+  FileSystem::Info info;
+  struct stat result;
+  if (stat(path.c_str(), &result) == -1) {
+    return info;
+  }
+
+  info.exists = true;
+  info.is_dir = S_ISDIR(result.st_mode);
+  info.size = result.st_size;
+#if defined(OS_MACOSX)
+  info.mtime = result.st_mtimespec.tv_sec * 1000000000ll +
+               result.st_mtimespec.tv_nsec;
+#else
+  info.mtime = result.st_mtim.tv_sec * 1000000000ll + result.st_mtim.tv_nsec;
+#endif
+  return info;
+}
+
+Entries ListSlow(const Path& dir_path) {
+  Stats::Timer timer(list_time);
+  list_calls.Add();
+
+  DIR* dir = opendir(dir_path.c_str());
+  if (!dir) {
+    return nullptr;
+  }
+
+  auto entries = std::make_shared<Vector<FileSystem::Entry>>();
+  while (auto* entry = readdir(dir)) {
+    const String name = entry->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+
+    // Some file systems don't report the type.
+    bool is_dir = entry->d_type == DT_DIR;
+    if (entry->d_type == DT_UNKNOWN) {
+      is_dir = FileSystem::Stat(dir_path + "/" + name).is_dir;
+    }
+    entries->push_back({name, is_dir});
+  }
+  closedir(dir);
+
+  std::sort(entries->begin(), entries->end(),
+            [](const auto& a, const auto& b) { return a.name < b.name; });
+  return entries;
+}
+
+}  // namespace
+
+// static
+FileSystem::Info FileSystem::Stat(const Path& path) {
+  auto& cache = shinobi::cache();
+  {
+    std::shared_lock<std::shared_mutex> lock(cache.mutex);
+    auto it = cache.infos.find(path);
+    if (it != cache.infos.end()) {
+      stat_hits.Add();
+      return it->second;
+    }
+  }
+
+  // Don't hold the lock during the call - the concurrent callers may stat the
+  // same path twice, but get the same result.
+  const auto info = StatSlow(path);
+
+  std::unique_lock<std::shared_mutex> lock(cache.mutex);
+  cache.infos.emplace(path, info);
+  return info;
+}
+
+// static
+void FileSystem::Prefetch(const Vector<Path>& paths, ThreadPool& pool) {
+  // Too small tasks would cost more than the calls.
+  constexpr size_t kBatchSize = 16;
+
+  for (size_t begin = 0; begin < paths.size(); begin += kBatchSize) {
+    pool.Push([&paths, begin] {
+      const auto end = std::min(begin + kBatchSize, paths.size());
+      for (auto i = begin; i < end; ++i) {
+        Stat(paths[i]);
+      }
+    });
+  }
+  pool.Wait();
+}
+
+// static
+bool FileSystem::List(const Path& dir_path, Vector<Entry>& entries) {
+  auto& cache = shinobi::cache();
+  Entries listing;
+  bool found = false;
+  {
+    std::shared_lock<std::shared_mutex> lock(cache.mutex);
+    auto it = cache.listings.find(dir_path);
+    if (it != cache.listings.end()) {
+      list_hits.Add();
+      listing = it->second;
+      found = true;
+    }
+  }
+
+  if (!found) {
+    listing = ListSlow(dir_path);
+    std::unique_lock<std::shared_mutex> lock(cache.mutex);
+    cache.listings.emplace(dir_path, listing);
+  }
+
+  if (!listing) {
+    return false;
+  }
+  entries = *listing;
+  return true;
+}
+
+// static
+bool FileSystem::Read(const Path& path, String& contents) {
+  const auto info = Stat(path);
+  if (!info.exists || info.is_dir) {
+    return false;
+  }
+
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+
+  // The size is a hint - the file may be changed since.
+  contents.clear();
+  contents.reserve(info.size);
+  char buffer[64 * 1024];
+  bool ok = true;
+  while (true) {
+    const ssize_t size = read(fd, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    if (size <= 0) {
+      ok = size == 0;
+      break;
+    }
+    contents.append(buffer, size);
+  }
+  close(fd);
+
+  bytes_read.Add(contents.size());
+  return ok;
+}
+
+// static
+void FileSystem::Invalidate(const Path& path) {
+  auto& cache = shinobi::cache();
+  std::unique_lock<std::shared_mutex> lock(cache.mutex);
+  cache.infos.erase(path);
+  cache.listings.erase(path);
+
+  const auto slash = path.rfind('/');
+  if (slash != Path::npos) {
+    cache.listings.erase(slash ? path.substr(0, slash) : "/");
+  }
+}
+
+// static
+void FileSystem::InvalidateAll() {
+  auto& cache = shinobi::cache();
+  std::unique_lock<std::shared_mutex> lock(cache.mutex);
+  cache.infos.clear();
+  cache.listings.clear();
+}
+
+}  // namespace shinobi
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <base/path.hh>
+#include <base/thread_pool.hh>
+
+namespace shinobi {
+
+// Process-wide cache of the file system metadata: each path is stat'ed and
+// each directory is listed only once - until it's invalidated, e.g. by the
+// file watcher. The contents aren't cached - the loaded files are cached by
+// their users - but the reads of the missing files don't touch the disk.
+class FileSystem {
+ public:
+  struct Info {
+    bool exists = false;
+    bool is_dir = false;
+    ui64 size = 0;
+    i64 mtime = 0;  // In nanoseconds.
+  };
+
+  struct Entry {
+    String name;
+    bool is_dir;
+  };
+
+  THREAD_SAFE static Info Stat(const Path& path);
+
+  // Stats the paths in parallel - on a slow file system the latency of the
+  // separate calls is hidden.
+  THREAD_SAFE static void Prefetch(const Vector<Path>& paths,
+                                   ThreadPool& pool);
+
+  // Returns the entries of the directory sorted by name - or false, if it
+  // can't be listed.
+  THREAD_SAFE static bool List(const Path& dir_path, Vector<Entry>& entries);
+
+  // Reads the whole file. Returns false, if it can't be read.
+  THREAD_SAFE static bool Read(const Path& path, String& contents);
+
+  // Forgets the path and the listing of its directory.
+  THREAD_SAFE static void Invalidate(const Path& path);
+  THREAD_SAFE static void InvalidateAll();
+};
+
+}  // namespace shinobi
@@ -0,0 +1,86 @@
+#include <base/file_system.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace shinobi {
+
+class FileSystemTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/file_system_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    dir = temp_dir;
+  }
+
+  void TearDown() override {
+    FileSystem::InvalidateAll();
+    ASSERT_EQ(0, system(("rm -rf " + dir).c_str()));
+  }
+
+  void Write(const String& name, const String& contents) {
+    std::ofstream(dir + "/" + name) << contents;
+  }
+
+  Path dir;
+};
+
+TEST_F(FileSystemTest, CachesUntilInvalidated) {
+  Write("a", "12345");
+  ASSERT_EQ(0, mkdir((dir + "/sub").c_str(), 0755));
+
+  const auto info = FileSystem::Stat(dir + "/a");
+  EXPECT_TRUE(info.exists);
+  EXPECT_FALSE(info.is_dir);
+  EXPECT_EQ(5u, info.size);
+  EXPECT_TRUE(FileSystem::Stat(dir + "/sub").is_dir);
+  EXPECT_FALSE(FileSystem::Stat(dir + "/b").exists);
+
+  Vector<FileSystem::Entry> entries;
+  ASSERT_TRUE(FileSystem::List(dir, entries));
+  ASSERT_EQ(2u, entries.size());
+  EXPECT_EQ("a", entries[0].name);
+  EXPECT_FALSE(entries[0].is_dir);
+  EXPECT_EQ("sub", entries[1].name);
+  EXPECT_TRUE(entries[1].is_dir);
+  EXPECT_FALSE(FileSystem::List(dir + "/missing", entries));
+
+  // The cached results don't see the changes.
+  Write("b", "1");
+  String contents;
+  EXPECT_FALSE(FileSystem::Stat(dir + "/b").exists);
+  EXPECT_FALSE(FileSystem::Read(dir + "/b", contents));
+  ASSERT_TRUE(FileSystem::List(dir, entries));
+  EXPECT_EQ(2u, entries.size());
+
+  // The invalidation drops the listing of the directory too.
+  FileSystem::Invalidate(dir + "/b");
+  EXPECT_TRUE(FileSystem::Stat(dir + "/b").exists);
+  ASSERT_TRUE(FileSystem::Read(dir + "/b", contents));
+  EXPECT_EQ("1", contents);
+  ASSERT_TRUE(FileSystem::List(dir, entries));
+  EXPECT_EQ(3u, entries.size());
+}
+
+TEST_F(FileSystemTest, Prefetch) {
+  Vector<Path> paths;
+  for (ui32 i = 0; i < 100; ++i) {
+    paths.push_back(dir + "/" + std::to_string(i));
+    if (i % 2) {
+      Write(std::to_string(i), "x");
+    }
+  }
+
+  ThreadPool pool(4);
+  FileSystem::Prefetch(paths, pool);
+  for (ui32 i = 0; i < paths.size(); ++i) {
+    EXPECT_EQ(i % 2 == 1, FileSystem::Stat(paths[i]).exists);
+  }
+}
+
+}  // namespace shinobi
@@ -0,0 +1,14 @@
+#include <base/hash.hh>
+
+namespace shinobi {
+
+ui64 Hash(const char* data, size_t size, ui64 seed) {
+  ui64 hash = seed;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<ui8>(data[i]);
+    hash *= 1099511628211u;
+  }
+  return hash;
+}
+
+}  // namespace shinobi
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <base/aliases.hh>
+
+namespace shinobi {
+
+// 64-bit FNV-1a hash: stable between runs and platforms, so it may be
+// persisted.
+ui64 Hash(const char* data, size_t size, ui64 seed = 14695981039346656037u);
+
+inline ui64 Hash(const String& data) {
+  return Hash(data.data(), data.size());
+}
+
+}  // namespace shinobi
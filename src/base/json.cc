@@ -0,0 +1,26 @@
+#include <base/json.hh>
+
+namespace shinobi {
+
+void AppendJsonString(const char* str, size_t size, String& output) {
+  static const char kHex[] = "0123456789abcdef";
+
+  output.reserve(output.size() + size + 2);
+  output += '"';
+  for (size_t i = 0; i < size; ++i) {
+    const unsigned char c = str[i];
+    if (c == '"' || c == '\\') {
+      output += '\\';
+      output += c;
+    } else if (c < 0x20) {
+      output += "\\u00";
+      output += kHex[c >> 4];
+      output += kHex[c & 0xf];
+    } else {
+      output += c;
+    }
+  }
+  output += '"';
+}
+
+}  // namespace shinobi
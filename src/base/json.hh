@@ -0,0 +1,16 @@
+#pragma once
+
+#include <base/aliases.hh>
+
+namespace shinobi {
+
+// Appends |str| to |output| as a quoted JSON string.
+void AppendJsonString(const char* str, size_t size, String& output);
+
+inline String JsonString(const String& str) {
+  String output;
+  AppendJsonString(str.data(), str.size(), output);
+  return output;
+}
+
+}  // namespace shinobi
@@ -0,0 +1,105 @@
+#include <base/label.hh>
+
+#include <base/assert.hh>
+
+#include STL(shared_mutex)
+
+namespace shinobi {
+
+struct Label::Entry {
+  const String* text;
+  Path dir;
+  String name;
+};
+
+namespace {
+
+struct Labels {
+  std::shared_mutex mutex;
+  Map<String, Label> entries;  // By the canonical text.
+};
+
+Labels& labels() {
+  static Labels labels;
+  return labels;
+}
+
+const String& EmptyString() {
+  static const String empty;
+  return empty;
+}
+
+}  // namespace
+
+Label::Label(const String& text) {
+  CHECK(Parse(text, Path(), *this) && ToString() == text);
+}
+
+// static
+bool Label::Parse(const String& text, const Path& dir, Label& label) {
+  if (text.empty()) {
+    return false;
+  }
+
+  const auto colon = text.find(':');
+
+  Path label_dir;
+  if (colon == 0) {
+    label_dir = dir;
+  } else if (!ResolvePath(text.substr(0, colon), dir, label_dir)) {
+    return false;
+  }
+  if (label_dir.compare(0, 2, "//") != 0) {
+    return false;
+  }
+
+  String name;
+  if (colon != String::npos) {
+    name = text.substr(colon + 1);
+  } else {
+    // "//src/base" means "//src/base:base".
+    name = label_dir.substr(label_dir.rfind('/') + 1);
+  }
+  if (name.empty() || name.find_first_of("/:") != String::npos) {
+    return false;
+  }
+
+  const String canonical = label_dir + ":" + name;
+
+  auto& labels = shinobi::labels();
+  {
+    std::shared_lock<std::shared_mutex> lock(labels.mutex);
+    auto it = labels.entries.find(canonical);
+    if (it != labels.entries.end()) {
+      label = it->second;
+      return true;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(labels.mutex);
+  auto result = labels.entries.emplace(canonical, Label());
+  if (result.second) {
+    result.first->second = Label(
+        new Entry{&result.first->first, std::move(label_dir), std::move(name)});
+  }
+  label = result.first->second;
+  return true;
+}
+
+const String& Label::ToString() const {
+  return entry_ ? *entry_->text : EmptyString();
+}
+
+const Path& Label::dir() const {
+  return entry_ ? entry_->dir : EmptyString();
+}
+
+const String& Label::name() const {
+  return entry_ ? entry_->name : EmptyString();
+}
+
+bool Label::operator<(const Label& other) const {
+  return entry_ != other.entry_ && ToString() < other.ToString();
+}
+
+}  // namespace shinobi
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <base/path.hh>
+
+#include STL(functional)
+
+namespace shinobi {
+
+// The absolute label of a target, like "//src/base:base". The labels are
+// canonicalized and interned on creation - so they're compared and hashed as
+// pointers, and never split again. The interned labels live as long as the
+// process.
+class Label {
+ public:
+  Label() = default;  // The invalid one.
+
+  // The canonical absolute |text| - CHECKs that it's valid.
+  explicit Label(const String& text);
+
+  // Resolves the |text| relative to the directory |dir|: ":base" and
+  // "//src/base:base" in "//src/base", and "base" in "//src", resolve to
+  // the same label. Returns false, if the label is malformed or goes above
+  // the source root.
+  THREAD_SAFE static bool Parse(const String& text, const Path& dir,
+                                Label& label);
+
+  const String& ToString() const;
+  const Path& dir() const;     // "//src/base"
+  const String& name() const;  // "base"
+
+  explicit operator bool() const { return entry_; }
+  bool operator==(const Label& other) const { return entry_ == other.entry_; }
+  bool operator!=(const Label& other) const { return entry_ != other.entry_; }
+
+  // Compares the text - so the order doesn't depend on the interning.
+  bool operator<(const Label& other) const;
+
+  size_t Hash() const { return std::hash<const void*>()(entry_); }
+
+ private:
+  struct Entry;
+
+  explicit Label(const Entry* entry) : entry_(entry) {}
+
+  const Entry* entry_ = nullptr;
+};
+
+}  // namespace shinobi
+
+template <>
+struct std::hash<shinobi::Label> {
+  size_t operator()(const shinobi::Label& label) const { return label.Hash(); }
+};
@@ -0,0 +1,95 @@
+#include <base/label.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(thread)
+
+namespace shinobi {
+
+namespace {
+
+Label Parse(const String& text, const Path& dir) {
+  Label label;
+  EXPECT_TRUE(Label::Parse(text, dir, label)) << text;
+  return label;
+}
+
+String Normalize(Path path) {
+  EXPECT_TRUE(NormalizePath(path)) << path;
+  return path;
+}
+
+}  // namespace
+
+TEST(PathTest, Normalize) {
+  EXPECT_EQ("//src/base", Normalize("//src/base"));
+  EXPECT_EQ("//src/base", Normalize("//src/./base/"));
+  EXPECT_EQ("//base", Normalize("//src/../base"));
+  EXPECT_EQ("//", Normalize("//src/.."));
+  EXPECT_EQ("/a/b", Normalize("/a//b/c/.."));
+  EXPECT_EQ("../b", Normalize("a/../../b"));
+  EXPECT_EQ(".", Normalize("a/.."));
+  EXPECT_EQ("", Normalize(""));
+
+  Path path = "//src/../..";
+  EXPECT_FALSE(NormalizePath(path));
+
+  Path result;
+  EXPECT_TRUE(ResolvePath("../a.cc", "//src/base", result));
+  EXPECT_EQ("//src/a.cc", result);
+  EXPECT_TRUE(ResolvePath("//a.cc", "//src/base", result));
+  EXPECT_EQ("//a.cc", result);
+  EXPECT_TRUE(ResolvePath("a.cc", "//", result));
+  EXPECT_EQ("//a.cc", result);
+}
+
+TEST(LabelTest, Canonicalizes) {
+  const Label label("//src/base:base");
+  EXPECT_EQ("//src/base:base", label.ToString());
+  EXPECT_EQ("//src/base", label.dir());
+  EXPECT_EQ("base", label.name());
+
+  EXPECT_EQ(label, Parse(":base", "//src/base"));
+  EXPECT_EQ(label, Parse("//src/base", "//other"));
+  EXPECT_EQ(label, Parse("base", "//src"));
+  EXPECT_EQ(label, Parse("../src/base:base", "//other"));
+  EXPECT_EQ(label, Parse("//src/./base/", "//"));
+  EXPECT_EQ(Label("//:all"), Parse(":all", "//"));
+  EXPECT_NE(label, Label("//src/base:other"));
+
+  EXPECT_LT(Label("//a:b"), Label("//b:a"));
+  EXPECT_FALSE(Label());
+  EXPECT_EQ(String(), Label().ToString());
+
+  Label invalid;
+  EXPECT_FALSE(Label::Parse("", "//src", invalid));
+  EXPECT_FALSE(Label::Parse("//", "//src", invalid));
+  EXPECT_FALSE(Label::Parse("//src:", "//src", invalid));
+  EXPECT_FALSE(Label::Parse("//src:a/b", "//src", invalid));
+  EXPECT_FALSE(Label::Parse("../..:a", "//src", invalid));
+  EXPECT_FALSE(Label::Parse(":a", "", invalid));
+  EXPECT_FALSE(invalid);
+}
+
+TEST(LabelTest, InternsConcurrently) {
+  Vector<Label> labels(4);
+  Vector<std::thread> threads;
+  for (ui32 i = 0; i < labels.size(); ++i) {
+    threads.emplace_back([i, &labels] {
+      for (ui32 j = 0; j < 1000; ++j) {
+        Parse(":t" + std::to_string(j), "//threads");
+      }
+      labels[i] = Parse(":t0", "//threads");
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& label : labels) {
+    EXPECT_EQ(Label("//threads:t0"), label);
+  }
+}
+
+}  // namespace shinobi
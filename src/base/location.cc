@@ -2,26 +2,82 @@
 
 #include <base/assert.hh>
 
+#include STL(atomic)
+#include STL(mutex)
+
 namespace shinobi {
 
-Location::Location(const Path& file_path, ui64 line_number, ui64 column_number,
-                   ui64 byte)
-    : path_(file_path),
-      line_(line_number),
-      column_(column_number),
-      byte_(byte) {
+namespace {
+
+// The interned paths are stored in chunks, that never move - so the lookup by
+// id doesn't take any locks.
+constexpr ui32 kChunkSize = 1024;
+constexpr ui32 kMaxChunks = 4096;
+
+struct Files {
+  Files() {
+    chunks[0].store(new Path[kChunkSize], std::memory_order_release);
+    ids.emplace(Path(), 0);
+  }
+
+  std::mutex mutex;
+  Map<Path, Location::FileId> ids;
+  std::atomic<Path*> chunks[kMaxChunks] = {};
+};
+
+Files& files() {
+  static Files files;
+  return files;
+}
+
+}  // namespace
+
+Location::Location(FileId file_id, ui32 line_number, ui32 column_number,
+                   ui32 byte)
+    : file_(file_id), line_(line_number), column_(column_number), byte_(byte) {
   DCHECK(line_ != INVALID_VALUE);
   DCHECK(column_ != INVALID_VALUE);
   DCHECK(byte_ != INVALID_VALUE);
 }
 
+Location::Location(const Path& file_path, ui32 line_number, ui32 column_number,
+                   ui32 byte)
+    : Location(Intern(file_path), line_number, column_number, byte) {}
+
+// static
+Location::FileId Location::Intern(const Path& file_path) {
+  auto& files = shinobi::files();
+  std::lock_guard<std::mutex> lock(files.mutex);
+
+  auto it = files.ids.find(file_path);
+  if (it != files.ids.end()) {
+    return it->second;
+  }
+
+  const FileId id = files.ids.size();
+  CHECK(id / kChunkSize < kMaxChunks);
+  auto& chunk = files.chunks[id / kChunkSize];
+  if (!chunk.load(std::memory_order_relaxed)) {
+    chunk.store(new Path[kChunkSize], std::memory_order_release);
+  }
+  chunk.load(std::memory_order_relaxed)[id % kChunkSize] = file_path;
+  files.ids.emplace(file_path, id);
+  return id;
+}
+
+const Path& Location::file_path() const {
+  // The id was published together with the path.
+  return files().chunks[file_ / kChunkSize].load(
+      std::memory_order_acquire)[file_ % kChunkSize];
+}
+
 Location::operator bool() const {
   return line_ != INVALID_VALUE && column_ != INVALID_VALUE &&
          byte_ != INVALID_VALUE;
 }
 
 bool Location::operator<(const Location& other) const {
-  DCHECK(path_ == other.path_);
+  DCHECK(file_ == other.file_);
   return std::tie(line_, column_) < std::tie(other.line_, other.column_);
 }
 
@@ -1,16 +1,29 @@
 #pragma once
 
 #include <base/aliases.hh>
+#include <base/attributes.hh>
 #include <base/path.hh>
 
+#include STL(type_traits)
+
 namespace shinobi {
 
+// A small value - the file path is interned and referred by id - so it's cheap
+// to copy, and may be kept for each token or node.
 class Location {
  public:
-  Location() {}
-  Location(const Path& file_path, ui64 line, ui64 column, ui64 byte);
+  using FileId = ui32;
+
+  Location() = default;
+  Location(FileId file_id, ui32 line, ui32 column, ui32 byte);
+  Location(const Path& file_path, ui32 line, ui32 column, ui32 byte);
 
-  const Path& file_path() const { return path_; }
+  // Returns the same id for the same path - for the lifetime of the process.
+  THREAD_SAFE static FileId Intern(const Path& file_path);
+
+  // The reference stays valid for the lifetime of the process.
+  const Path& file_path() const;
+  FileId file_id() const { return file_; }
   ui64 line() const { return line_; }
   ui64 column() const { return column_; }
   ui64 byte() const { return byte_; }
@@ -19,11 +32,10 @@ class Location {
   bool operator<(const Location& other) const;
 
  private:
-  static constexpr ui64 INVALID_VALUE = 0u;
+  static constexpr ui32 INVALID_VALUE = 0u;
 
-  const Path path_;
-  const ui64 line_ = INVALID_VALUE, column_ = INVALID_VALUE,
-             byte_ = INVALID_VALUE;
+  FileId file_ = 0;  // The empty path.
+  ui32 line_ = INVALID_VALUE, column_ = INVALID_VALUE, byte_ = INVALID_VALUE;
 };
 
 class LocationRange {
@@ -35,7 +47,13 @@ class LocationRange {
   const Location& end() const { return end_; }
 
  private:
-  const Location begin_, end_;
+  Location begin_, end_;
 };
 
+static_assert(std::is_trivially_copyable<Location>::value &&
+                  sizeof(Location) == 16,
+              "Location should fit into two registers");
+static_assert(std::is_trivially_copyable<LocationRange>::value,
+              "LocationRange should be trivially copyable");
+
 }  // namespace shinobi
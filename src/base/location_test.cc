@@ -0,0 +1,48 @@
+#include <base/location.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(thread)
+
+namespace shinobi {
+
+TEST(LocationTest, InternsPaths) {
+  const Location location("//a/BUILD.shi", 1, 2, 3);
+  const Location same_file("//a/BUILD.shi", 4, 5, 6);
+  const Location other_file("//b/BUILD.shi", 1, 2, 3);
+
+  EXPECT_EQ(location.file_id(), same_file.file_id());
+  EXPECT_NE(location.file_id(), other_file.file_id());
+  EXPECT_EQ("//a/BUILD.shi", location.file_path());
+  EXPECT_EQ("//b/BUILD.shi", other_file.file_path());
+  EXPECT_EQ(String(), Location().file_path());
+  EXPECT_FALSE(Location());
+
+  // Many more paths than fit in a single chunk.
+  Vector<std::thread> threads;
+  for (ui32 i = 0; i < 4; ++i) {
+    threads.emplace_back([i] {
+      for (ui32 j = 0; j < 1000; ++j) {
+        const Path path = "//" + std::to_string(i) + "/" + std::to_string(j);
+        EXPECT_EQ(path, Location(path, 1, 1, 1).file_path());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(LocationTest, CopiesRange) {
+  const Location begin("//BUILD.shi", 1, 1, 1);
+  const Location end(begin.file_id(), 1, 5, 5);
+  LocationRange range(begin, end);
+  LocationRange copy = range;
+
+  EXPECT_EQ("//BUILD.shi", copy.end().file_path());
+  EXPECT_EQ(5u, copy.end().column());
+  EXPECT_TRUE(copy.begin() < copy.end());
+}
+
+}  // namespace shinobi
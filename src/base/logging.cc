@@ -1,6 +1,6 @@
 #include <base/logging.hh>
 
-#include STL(iostream)
+#include <base/async_log_sink.hh>
 
 #if !defined(OS_WIN)
 #include <syslog.h>
@@ -10,12 +10,21 @@
 
 namespace shinobi {
 
+// Constant-initialized, so the logs from the static initializers of the other
+// units see the default configuration, instead of nothing.
+std::atomic<const Log::Config*> Log::current_(nullptr);
+std::atomic<ui64> Log::mask_(
+    (1ull << named_levels::FATAL) | (1ull << named_levels::ASSERT));
+
 // static
 void Log::SetMode(Mode mode) {
+  std::lock_guard<std::mutex> lock(writer_mutex());
+  const Config* current = Current(std::memory_order_relaxed);
+
 #if !defined(OS_WIN)
-  if (Log::mode() == CONSOLE && mode == SYSLOG) {
+  if (current->mode == CONSOLE && mode == SYSLOG) {
     openlog(nullptr, 0, LOG_DAEMON);
-  } else if (Log::mode() == SYSLOG && mode == CONSOLE) {
+  } else if (current->mode == SYSLOG && mode == CONSOLE) {
     closelog();
   }
 #else
@@ -23,7 +32,27 @@ void Log::SetMode(Mode mode) {
   mode = CONSOLE;
 #endif  // !defined(OS_WIN)
 
-  Log::mode() = mode;
+  Publish(UniquePtr<Config>(
+      new Config{current->error_mark, current->ranges, mode, current->sink}));
+}
+
+// static
+void Log::SetAsync(bool async) {
+  std::lock_guard<std::mutex> lock(writer_mutex());
+  const Config* current = Current(std::memory_order_relaxed);
+
+  if (async && !async_sink()) {
+    async_sink().reset(new AsyncLogSink);
+  }
+
+  // The sink isn't destroyed on disabling, since there may be messages in
+  // flight with the previous configuration.
+  Publish(UniquePtr<Config>(new Config{current->error_mark, current->ranges,
+                                       current->mode,
+                                       async ? async_sink().get() : nullptr}));
+  if (!async && async_sink()) {
+    async_sink()->Flush();
+  }
 }
 
 // static
@@ -38,50 +67,58 @@ void Log::Reset(ui32 error_mark, RangeSet&& ranges) {
     prev = range.first;
   }
 
-  Log::error_mark() = error_mark;
-  Log::ranges().reset(new RangeSet(std::move(ranges)));
+  ui64 mask = (1ull << named_levels::FATAL) | (1ull << named_levels::ASSERT);
+  for (ui32 level = 0; level < kMaskBits; ++level) {
+    if (Matches(ranges, level)) {
+      mask |= 1ull << level;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(writer_mutex());
+  const Config* current = Current(std::memory_order_relaxed);
+  Publish(UniquePtr<Config>(new Config{error_mark, std::move(ranges),
+                                       current->mode, current->sink}));
+  mask_.store(mask, std::memory_order_relaxed);
 }
 
 Log::Log(ui32 level)
-    : level_(level),
-      error_mark_(error_mark()),
-      ranges_(ranges()),
-      mode_(mode()) {}
+    : level_(level), config_(Current(std::memory_order_acquire)) {}
+
+Log::Log(Log&& other)
+    : level_(other.level_),
+      config_(other.config_),
+      stream_(std::move(other.stream_)) {
+  other.config_ = nullptr;
+}
 
 Log::~Log() {
-  auto it = ranges_->lower_bound(std::make_pair(level_, 0));
-  if ((it != ranges_->end() && level_ >= it->second) ||
-      level_ == named_levels::ASSERT) {
+  if (!config_) {
+    return;
+  }
+
+  if (Matches(config_->ranges, level_) || level_ == named_levels::ASSERT) {
     stream_ << std::endl;
 
-    if (mode_ == CONSOLE) {
-      auto& output_stream = (level_ <= error_mark_) ? std::cerr : std::cout;
-      output_stream << stream_.str() << std::flush;
-    } else if (mode_ == SYSLOG) {
-#if !defined(OS_WIN)
-      // FIXME: not really a fair mapping.
-      switch (level_) {
-        case named_levels::FATAL:
-        case named_levels::ASSERT:
-          syslog(LOG_CRIT, "%s", stream_.str().c_str());
-          break;
-
-        case named_levels::ERROR:
-          syslog(LOG_ERR, "%s", stream_.str().c_str());
-          break;
-
-        case named_levels::WARNING:
-          syslog(LOG_WARNING, "%s", stream_.str().c_str());
-          break;
-
-        case named_levels::INFO:
-          syslog(LOG_NOTICE, "%s", stream_.str().c_str());
-          break;
-
-        default:
-          syslog(LOG_INFO, "%s", stream_.str().c_str());
+    const bool terminal =
+        level_ == named_levels::FATAL || level_ == named_levels::ASSERT;
+
+    AsyncLogSink::Destination destination = AsyncLogSink::SYSLOG;
+    if (config_->mode == CONSOLE) {
+      destination = (terminal || level_ <= config_->error_mark)
+                        ? AsyncLogSink::STDERR
+                        : AsyncLogSink::STDOUT;
+    }
+
+    const String text = stream_.str();
+    AsyncLogSink* sink = config_->sink;
+
+    if (sink && !terminal && sink->Push(destination, level_, text)) {
+      // Will be written in background.
+    } else if (!sink || terminal || level_ <= config_->error_mark) {
+      if (sink) {
+        sink->Flush();
       }
-#endif  // !defined(OS_WIN)
+      AsyncLogSink::Write(destination, level_, text);
     }
   }
 
@@ -101,22 +138,55 @@ Log& Log::operator<<(std::ostream& (*func)(std::ostream&)) {
 }
 
 // static
-ui32& Log::error_mark() {
-  static ui32 error_mark = 0;
-  return error_mark;
+bool Log::IsEnabledSlow(ui32 level) {
+  return Matches(Current(std::memory_order_acquire)->ranges, level);
+}
+
+// static
+bool Log::Matches(const RangeSet& ranges, ui32 level) {
+  auto it = ranges.lower_bound(std::make_pair(level, 0));
+  return it != ranges.end() && level >= it->second;
+}
+
+// static
+void Log::Publish(UniquePtr<Config>&& config) {
+  current_.store(config.get(), std::memory_order_release);
+  snapshots().emplace_back(std::move(config));
+}
+
+// static
+const Log::Config* Log::Current(std::memory_order order) {
+  const Config* config = current_.load(order);
+  return config ? config : DefaultConfig();
+}
+
+// static
+const Log::Config* Log::DefaultConfig() {
+  // Never destroyed, like the snapshots - a message may be in flight with it.
+  static const Config* const config = new Config{
+      named_levels::FATAL,
+      {std::make_pair(named_levels::FATAL, named_levels::FATAL)},
+      CONSOLE,
+      nullptr};
+  return config;
+}
+
+// static
+Vector<UniquePtr<const Log::Config>>& Log::snapshots() {
+  static Vector<UniquePtr<const Config>> snapshots;
+  return snapshots;
 }
 
 // static
-SharedPtr<Log::RangeSet>& Log::ranges() {
-  static SharedPtr<RangeSet> ranges(
-      new RangeSet{std::make_pair(named_levels::FATAL, named_levels::FATAL)});
-  return ranges;
+UniquePtr<AsyncLogSink>& Log::async_sink() {
+  static UniquePtr<AsyncLogSink> sink;
+  return sink;
 }
 
 // static
-Log::Mode& Log::mode() {
-  static Mode mode = CONSOLE;
-  return mode;
+std::mutex& Log::writer_mutex() {
+  static std::mutex mutex;
+  return mutex;
 }
 
 }  // namespace shinobi
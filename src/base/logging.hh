@@ -2,11 +2,15 @@
 
 #include <base/aliases.hh>
 
+#include STL(atomic)
+#include STL(mutex)
 #include STL(set)
 #include STL(sstream)
 
 namespace shinobi {
 
+class AsyncLogSink;
+
 // Since the enum values are defined in the parent's scope - to be able to use
 // something like this:
 //
@@ -71,13 +75,33 @@ class Log {
   // We need a separate method to be able to change mode before daemonizing.
   static void SetMode(Mode mode);
 
-  // Expects, that ranges are already filtered.
+  // Messages are written by the background thread, except |FATAL| and |ASSERT|
+  // ones: those flush everything logged before and are written synchronously.
+  // Messages that overflow the sink are dropped, unless they are errors.
+  static void SetAsync(bool async);
+
+  // Expects, that ranges are already filtered. Safe to call at any moment, even
+  // while other threads are logging.
   static void Reset(ui32 error_mark, RangeSet&& ranges);
 
+  // Cheap check, whether a message of |level| will be emitted. |LOG()| uses it
+  // to skip the construction and the formatting of filtered-out messages.
+  static bool IsEnabled(ui32 level) {
+    if (level < kMaskBits) {
+      return mask_.load(std::memory_order_relaxed) & (1ull << level);
+    }
+    return IsEnabledSlow(level);
+  }
+
+  // Allows to use the whole |LOG() << ...| expression inside the ternary.
+  struct Voidify {
+    void operator&(const Log&) const {}
+  };
+
   Log(ui32 level);
   ~Log();
 
-  Log(Log&&) = default;
+  Log(Log&& other);  // The moved-from log does nothing on destruction.
   Log(const Log&) = delete;
   Log& operator=(const Log&) = delete;
 
@@ -102,15 +126,41 @@ class Log {
   Log& operator<<(std::ostream& (*func)(std::ostream&));  // for |std::endl|
 
  private:
-  static ui32& error_mark();
-  static SharedPtr<RangeSet>& ranges();
-  static Mode& mode();
+  // Immutable snapshot of the whole configuration. Reconfiguration publishes a
+  // new snapshot, so readers only need an acquire load - without touching any
+  // shared reference counter. The replaced snapshots are kept alive till exit,
+  // since a message may still be in flight with them.
+  struct Config {
+    ui32 error_mark;
+    RangeSet ranges;
+    Mode mode;
+    AsyncLogSink* sink;  // Synchronous output, if null.
+  };
+
+  static constexpr ui32 kMaskBits = 64;
+
+  static bool IsEnabledSlow(ui32 level);
+  static bool Matches(const RangeSet& ranges, ui32 level);
+
+  // Should be called with |writer_mutex()| locked.
+  static void Publish(UniquePtr<Config>&& config);
+
+  // Falls back to the default configuration, if none is published yet.
+  static const Config* Current(std::memory_order order);
+  static const Config* DefaultConfig();
+  static Vector<UniquePtr<const Config>>& snapshots();
+  static std::mutex& writer_mutex();
+  static UniquePtr<AsyncLogSink>& async_sink();
+
+  static std::atomic<const Config*> current_;
+
+  // Bit per level below |kMaskBits|, cached from the ranges on |Reset()|.
+  // |FATAL| and |ASSERT| are always set, since they terminate the program.
+  static std::atomic<ui64> mask_;
 
   ui32 level_;
-  ui32 error_mark_;
-  SharedPtr<RangeSet> ranges_;
+  const Config* config_;
   std::stringstream stream_;
-  Mode mode_ = CONSOLE;
 };
 
 }  // namespace dist_clang
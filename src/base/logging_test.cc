@@ -0,0 +1,76 @@
+#include <base/logging.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include <base/using_log.hh>
+
+namespace shinobi {
+
+namespace {
+
+class LoggingTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    Log::Reset(named_levels::FATAL, {std::make_pair(named_levels::FATAL,
+                                                    named_levels::FATAL)});
+  }
+};
+
+int Count(int& counter) {
+  return ++counter;
+}
+
+}  // namespace
+
+TEST_F(LoggingTest, FilteredArgumentsAreNotEvaluated) {
+  Log::Reset(named_levels::ERROR,
+             {std::make_pair(named_levels::WARNING, named_levels::FATAL)});
+
+  int counter = 0;
+  LOG(TRACE) << Count(counter);
+  LOG(INFO) << Count(counter);
+  EXPECT_EQ(0, counter);
+
+  LOG(WARNING) << "Counter: " << Count(counter);
+  EXPECT_EQ(1, counter);
+}
+
+TEST_F(LoggingTest, CompiledOutLevels) {
+  Log::Reset(named_levels::ERROR,
+             {std::make_pair(named_levels::TRACE, named_levels::FATAL)});
+
+  int counter = 0;
+  LOG(TRACE) << Count(counter);
+  EXPECT_EQ(TRACE <= COMPILED_LOG_LEVEL ? 1 : 0, counter);
+
+  counter = 0;
+  DLOG(ERROR) << Count(counter);
+#if defined(NDEBUG)
+  EXPECT_EQ(0, counter);
+#else
+  EXPECT_EQ(1, counter);
+#endif
+}
+
+TEST_F(LoggingTest, IsEnabled) {
+  Log::Reset(named_levels::ERROR,
+             {std::make_pair(named_levels::ERROR, named_levels::ERROR),
+              std::make_pair(named_levels::TRACE, named_levels::INFO)});
+
+  EXPECT_TRUE(Log::IsEnabled(named_levels::FATAL));
+  EXPECT_TRUE(Log::IsEnabled(named_levels::ASSERT));
+  EXPECT_TRUE(Log::IsEnabled(named_levels::ERROR));
+  EXPECT_FALSE(Log::IsEnabled(named_levels::WARNING));
+  EXPECT_TRUE(Log::IsEnabled(named_levels::INFO));
+  EXPECT_TRUE(Log::IsEnabled(named_levels::TRACE));
+  EXPECT_FALSE(Log::IsEnabled(named_levels::TRACE + 1));
+  EXPECT_FALSE(Log::IsEnabled(100));
+
+  Log::Reset(named_levels::ERROR, {std::make_pair(100u, 90u)});
+  EXPECT_FALSE(Log::IsEnabled(named_levels::ERROR));
+  EXPECT_TRUE(Log::IsEnabled(100));
+  EXPECT_FALSE(Log::IsEnabled(101));
+}
+
+}  // namespace shinobi
@@ -0,0 +1,281 @@
+#include <base/memory.hh>
+
+#include <base/assert.hh>
+#include <base/json.hh>
+#include <base/memory_internal.hh>
+
+#include STL(algorithm)
+#include STL(cstring)
+#include STL(iomanip)
+#include STL(mutex)
+
+#include <sys/resource.h>
+
+namespace shinobi {
+
+namespace {
+
+constexpr ui32 kMaxPhases = 32;
+constexpr ui32 kMaxFiles = 10;  // The largest ones, which are printed.
+
+struct alignas(64) OwnerState {
+  std::atomic<i64> current, peak;
+  std::atomic<ui64> allocations;
+};
+
+// Zero-initialized before any allocation - no constructors.
+OwnerState owners[Memory::OWNER_SIZE];
+std::atomic<i64> total_current;
+std::atomic<i64> phase_peaks[kMaxPhases];
+std::atomic<ui32> current_phase;
+
+// Trivial thread-locals - they don't allocate on the first access.
+thread_local Memory::Owner current_owner = Memory::OTHER;
+thread_local Memory::File::Usage* current_file = nullptr;
+
+struct Registry {
+  std::mutex mutex;
+  Vector<const char*> phases = {nullptr};  // The index 0 is no phase.
+  Map<Path, i64> files;
+};
+
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+
+inline void UpdateMax(std::atomic<i64>& peak, i64 value) {
+  i64 old_value = peak.load(std::memory_order_relaxed);
+  while (old_value < value &&
+         !peak.compare_exchange_weak(old_value, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+namespace internal {
+
+bool memory_hooks_linked = false;
+
+Memory::Owner CurrentMemoryOwner() {
+  return current_owner;
+}
+
+void AccountMemory(ui32 owner, i64 size) {
+  auto& state = owners[owner];
+  const i64 current =
+      state.current.fetch_add(size, std::memory_order_relaxed) + size;
+  const i64 total = total_current.fetch_add(size, std::memory_order_relaxed) +
+                    size;
+
+  if (size > 0) {
+    state.allocations.fetch_add(1, std::memory_order_relaxed);
+    UpdateMax(state.peak, current);
+
+    const ui32 phase = current_phase.load(std::memory_order_relaxed);
+    if (phase) {
+      UpdateMax(phase_peaks[phase], total);
+    }
+  }
+
+  if (auto* file = current_file) {
+    file->current += size;
+    file->peak = std::max(file->peak, file->current);
+  }
+}
+
+}  // namespace internal
+
+namespace {
+
+const char* PrintOwner(Memory::Owner owner) {
+  switch (owner) {
+    case Memory::OTHER:
+      return "other";
+    case Memory::TOKENS:
+      return "tokens";
+    case Memory::AST:
+      return "ast";
+    case Memory::SCOPES:
+      return "scopes";
+    case Memory::GRAPH:
+      return "graph";
+    case Memory::OUTPUT:
+      return "output";
+    case Memory::OWNER_SIZE:
+      break;
+  }
+
+  NOTREACHED();
+  return "";
+}
+
+}  // namespace
+
+// static
+std::atomic<bool> Memory::enabled_(false);
+
+Memory::Scope::Scope(Owner owner) : previous_(current_owner) {
+  current_owner = owner;
+}
+
+Memory::Scope::~Scope() {
+  current_owner = previous_;
+}
+
+Memory::Phase::Phase(const char* name) {
+  if (!enabled()) {
+    return;
+  }
+
+  auto& registry = shinobi::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  ui32 index = 1;
+  while (index < registry.phases.size() &&
+         std::strcmp(registry.phases[index], name) != 0) {
+    ++index;
+  }
+  if (index == registry.phases.size()) {
+    CHECK(index < kMaxPhases);
+    registry.phases.push_back(name);
+  }
+
+  UpdateMax(phase_peaks[index], total_current.load(std::memory_order_relaxed));
+  previous_ = current_phase.exchange(index, std::memory_order_relaxed);
+}
+
+Memory::Phase::~Phase() {
+  if (enabled()) {
+    current_phase.store(previous_, std::memory_order_relaxed);
+  }
+}
+
+Memory::File::File(const Path& path) : path_(path), previous_(current_file) {
+  if (enabled()) {
+    current_file = &usage_;
+  }
+}
+
+Memory::File::~File() {
+  if (!enabled()) {
+    return;
+  }
+
+  current_file = previous_;
+
+  auto& registry = shinobi::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto& peak = registry.files[path_];
+  peak = std::max(peak, usage_.peak);
+}
+
+// static
+bool Memory::Enable() {
+  if (!internal::memory_hooks_linked) {
+    return false;
+  }
+  enabled_.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+// static
+void Memory::Disable() {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+// static
+void Memory::Print(std::ostream& stream, Stats::Format format) {
+  Vector<Pair<String, i64>> phases, files;
+  {
+    auto& registry = shinobi::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ui32 i = 1; i < registry.phases.size(); ++i) {
+      phases.emplace_back(registry.phases[i],
+                          phase_peaks[i].load(std::memory_order_relaxed));
+    }
+    files.assign(registry.files.begin(), registry.files.end());
+  }
+
+  std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+  if (files.size() > kMaxFiles) {
+    files.resize(kMaxFiles);
+  }
+
+  if (format == Stats::JSON) {
+    stream << "{\"owners\":{";
+    for (ui32 i = 0; i < OWNER_SIZE; ++i) {
+      const auto usage = Get(static_cast<Owner>(i));
+      stream << (i ? ",\n " : "\n ") << "\"" << PrintOwner(static_cast<Owner>(i))
+             << "\":{\"current\":" << usage.current
+             << ",\"peak\":" << usage.peak
+             << ",\"allocations\":" << usage.allocations << "}";
+    }
+    for (const auto* section : {&phases, &files}) {
+      stream << "},\n\"" << (section == &phases ? "phases" : "files")
+             << "\":{";
+      for (size_t i = 0; i < section->size(); ++i) {
+        stream << (i ? ",\n " : "\n ") << JsonString((*section)[i].first)
+               << ":" << (*section)[i].second;
+      }
+    }
+    stream << "},\n\"peak_rss\":" << PeakRss() << "}\n";
+    return;
+  }
+
+  stream << std::left << std::setw(10) << "owner" << std::right
+         << std::setw(14) << "current B" << std::setw(14) << "peak B"
+         << std::setw(14) << "allocations"
+         << "\n";
+  for (ui32 i = 0; i < OWNER_SIZE; ++i) {
+    const auto usage = Get(static_cast<Owner>(i));
+    stream << std::left << std::setw(10) << PrintOwner(static_cast<Owner>(i))
+           << std::right << std::setw(14) << usage.current << std::setw(14)
+           << usage.peak << std::setw(14) << usage.allocations << "\n";
+  }
+
+  for (const auto* section : {&phases, &files}) {
+    if (section->empty()) {
+      continue;
+    }
+
+    size_t width = 0;
+    for (const auto& entry : *section) {
+      width = std::max(width, entry.first.size());
+    }
+    stream << "\n"
+           << std::left << std::setw(width + 2)
+           << (section == &phases ? "phase" : "file") << std::right
+           << std::setw(14) << "peak B"
+           << "\n";
+    for (const auto& entry : *section) {
+      stream << std::left << std::setw(width + 2) << entry.first << std::right
+             << std::setw(14) << entry.second << "\n";
+    }
+  }
+
+  stream << "\npeak RSS " << PeakRss() << " B\n";
+}
+
+// static
+Memory::Usage Memory::Get(Owner owner) {
+  Usage usage;
+  usage.current = owners[owner].current.load(std::memory_order_relaxed);
+  usage.peak = owners[owner].peak.load(std::memory_order_relaxed);
+  usage.allocations = owners[owner].allocations.load(std::memory_order_relaxed);
+  return usage;
+}
+
+// static
+ui64 Memory::PeakRss() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == -1) {
+    return 0;
+  }
+  return static_cast<ui64>(usage.ru_maxrss) * 1024;  // In kilobytes on Linux.
+}
+
+}  // namespace shinobi
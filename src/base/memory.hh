@@ -0,0 +1,107 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/attributes.hh>
+#include <base/path.hh>
+#include <base/stats.hh>
+
+#include STL(atomic)
+#include STL(ostream)
+
+namespace shinobi {
+
+// Accounts the heap memory by owner - the subsystem, that allocates it - via the
+// hooks of the global |operator new|. Each block remembers its owner, so it's
+// released from the same owner on any thread. Also tracks the peak of the live
+// memory per phase and per file. While disabled, an allocation costs a single
+// relaxed load. The hooks add a header to each block, so only the diagnostic
+// builds link them - see "config_memory_accounting".
+class Memory {
+ public:
+  enum Owner {
+    OTHER,
+    TOKENS,  // Tokens and their values.
+    AST,     // Parsed and optimized trees.
+    SCOPES,  // Evaluator scopes and values.
+    GRAPH,   // Targets and the dependency graph.
+    OUTPUT,  // Generated files' buffers.
+    OWNER_SIZE,
+  };
+
+  struct Usage {
+    i64 current = 0, peak = 0;
+    ui64 allocations = 0;
+  };
+
+  // Attributes the allocations of the current thread to the |owner| - for the
+  // lifetime of the scope.
+  class Scope {
+   public:
+    explicit Scope(Owner owner);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    const Owner previous_;
+  };
+
+  // The phases are sequential, like "evaluate" or "write" - the peak of all
+  // live memory is recorded for each. |name| should outlive the accounting -
+  // e.g. be a string literal.
+  class Phase {
+   public:
+    explicit Phase(const char* name);
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+   private:
+    ui32 previous_ = 0;
+  };
+
+  // Records the peak of memory, allocated by the current thread while the file
+  // is processed. The largest peak is kept, if the file is processed again.
+  class File {
+   public:
+    explicit File(const Path& path);
+    ~File();
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    struct Usage {
+      i64 current = 0, peak = 0;
+    };
+
+   private:
+    const Path path_;
+    Usage usage_;
+    Usage* previous_ = nullptr;
+  };
+
+  // Returns false, if the hooks aren't linked.
+  THREAD_UNSAFE static bool Enable();
+  // The blocks, allocated while enabled, are still accounted on release.
+  THREAD_UNSAFE static void Disable();
+
+  inline static bool enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Prints the usage by owner, the peaks of phases, the files with the largest
+  // peaks and the peak RSS of the process.
+  THREAD_SAFE static void Print(std::ostream& stream, Stats::Format format);
+
+  THREAD_SAFE static Usage Get(Owner owner);
+
+  // The peak resident set size of the process in bytes.
+  THREAD_SAFE static ui64 PeakRss();
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace shinobi
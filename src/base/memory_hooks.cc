@@ -0,0 +1,111 @@
+#include <base/memory_internal.hh>
+
+#include STL(cstdlib)
+#include STL(new)
+
+namespace shinobi {
+
+namespace {
+
+constexpr ui32 kUntracked = Memory::OWNER_SIZE;
+
+// Precedes each allocated block. Keeps the alignment of |malloc()|.
+struct alignas(16) Header {
+  ui64 size;
+  ui32 owner;
+};
+
+// Runs before |main()| - the accounting is enabled only later.
+[[maybe_unused]] const bool linked = (internal::memory_hooks_linked = true);
+
+void* Allocate(size_t size) noexcept {
+  if (size > SIZE_MAX - sizeof(Header)) {
+    return nullptr;
+  }
+
+  auto* header = static_cast<Header*>(std::malloc(size + sizeof(Header)));
+  if (!header) {
+    return nullptr;
+  }
+
+  header->size = size;
+  header->owner = kUntracked;
+  if (Memory::enabled()) {
+    header->owner = internal::CurrentMemoryOwner();
+    internal::AccountMemory(header->owner, size);
+  }
+  return header + 1;
+}
+
+void* AllocateOrThrow(size_t size) {
+  while (true) {
+    if (void* block = Allocate(size)) {
+      return block;
+    }
+
+    auto handler = std::get_new_handler();
+    if (!handler) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void Release(void* block) noexcept {
+  if (!block) {
+    return;
+  }
+
+  auto* header = static_cast<Header*>(block) - 1;
+  if (header->owner != kUntracked) {
+    internal::AccountMemory(header->owner, -static_cast<i64>(header->size));
+  }
+  std::free(header);
+}
+
+}  // namespace
+
+}  // namespace shinobi
+
+// The hooks. The aligned versions aren't replaced - they don't interfere,
+// since the default ones allocate and free by themselves.
+
+void* operator new(size_t size) {
+  return shinobi::AllocateOrThrow(size);
+}
+
+void* operator new[](size_t size) {
+  return shinobi::AllocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return shinobi::Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return shinobi::Allocate(size);
+}
+
+void operator delete(void* block) noexcept {
+  shinobi::Release(block);
+}
+
+void operator delete[](void* block) noexcept {
+  shinobi::Release(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+  shinobi::Release(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+  shinobi::Release(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+  shinobi::Release(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+  shinobi::Release(block);
+}
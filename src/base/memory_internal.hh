@@ -0,0 +1,17 @@
+#pragma once
+
+#include <base/memory.hh>
+
+// The accounting, shared with the hooks of the global |operator new| - which
+// are linked only into the diagnostic builds. See "//src/base:memory_hooks".
+namespace shinobi::internal {
+
+// Set by the hooks, when they are linked.
+extern bool memory_hooks_linked;
+
+Memory::Owner CurrentMemoryOwner();
+
+// The |size| is negative for the released blocks.
+void AccountMemory(ui32 owner, i64 size);
+
+}  // namespace shinobi::internal
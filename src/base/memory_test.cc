@@ -0,0 +1,65 @@
+#include <base/memory.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(sstream)
+#include STL(thread)
+
+namespace shinobi {
+
+class MemoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(Memory::Enable()); }
+  void TearDown() override { Memory::Disable(); }
+};
+
+TEST_F(MemoryTest, AccountsByOwner) {
+  const auto before = Memory::Get(Memory::OUTPUT);
+  UniquePtr<char[]> block;
+  {
+    Memory::Scope scope(Memory::OUTPUT);
+    block.reset(new char[1000000]);
+  }
+
+  auto after = Memory::Get(Memory::OUTPUT);
+  EXPECT_EQ(before.current + 1000000, after.current);
+  EXPECT_LE(after.current, after.peak);
+  EXPECT_EQ(before.allocations + 1, after.allocations);
+
+  // Released from the same owner - on any thread, in any scope.
+  std::thread([&block] { block.reset(); }).join();
+  after = Memory::Get(Memory::OUTPUT);
+  EXPECT_EQ(before.current, after.current);
+  EXPECT_LE(before.current + 1000000, after.peak);
+}
+
+TEST_F(MemoryTest, RecordsPhasesAndFiles) {
+  {
+    Memory::Phase phase("test_phase");
+    Memory::File file("//test/BUILD.shi");
+    Vector<char> buffer(2000000);
+    buffer.clear();
+    buffer.shrink_to_fit();
+  }
+
+  std::stringstream table;
+  Memory::Print(table, Stats::TABLE);
+  const String output = table.str();
+  EXPECT_NE(String::npos, output.find("\ntokens ")) << output;
+  EXPECT_NE(String::npos, output.find("\ntest_phase ")) << output;
+  EXPECT_NE(String::npos, output.find("\n//test/BUILD.shi")) << output;
+  EXPECT_NE(String::npos, output.find("\npeak RSS ")) << output;
+
+  std::stringstream json;
+  Memory::Print(json, Stats::JSON);
+  const String key = "\"//test/BUILD.shi\":";
+  const auto pos = json.str().find(key);
+  ASSERT_NE(String::npos, pos) << json.str();
+  // Give some slack to the small blocks, released meanwhile.
+  EXPECT_NEAR(2000000, std::stoll(json.str().substr(pos + key.size())), 1000);
+  EXPECT_NE(String::npos, json.str().find("\"peak_rss\":"));
+  EXPECT_LT(0u, Memory::PeakRss());
+}
+
+}  // namespace shinobi
@@ -0,0 +1,104 @@
+#include <base/path.hh>
+
+namespace shinobi {
+
+namespace {
+
+// The length of the leading "/" or "//".
+size_t RootSize(const Path& path) {
+  if (path.compare(0, 2, "//") == 0) {
+    return 2;
+  }
+  return !path.empty() && path[0] == '/' ? 1 : 0;
+}
+
+bool IsNormal(const Path& path, size_t root) {
+  if (path.size() == root) {
+    return true;
+  }
+
+  size_t begin = root;
+  while (begin <= path.size()) {
+    auto end = path.find('/', begin);
+    if (end == Path::npos) {
+      end = path.size();
+    }
+
+    const size_t size = end - begin;
+    if (size == 0 || (size == 1 && path[begin] == '.') ||
+        (size == 2 && path[begin] == '.' && path[begin + 1] == '.')) {
+      return false;
+    }
+    begin = end + 1;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool NormalizePath(Path& path) {
+  const size_t root = RootSize(path);
+  if (IsNormal(path, root)) {
+    return true;
+  }
+
+  Vector<Pair<size_t>> components;  // The offset and size of each one.
+  size_t leading_parents = 0;       // ".." of a relative path.
+
+  size_t begin = root;
+  while (begin <= path.size()) {
+    auto end = path.find('/', begin);
+    if (end == Path::npos) {
+      end = path.size();
+    }
+
+    const size_t size = end - begin;
+    if (size == 2 && path[begin] == '.' && path[begin + 1] == '.') {
+      if (!components.empty()) {
+        components.pop_back();
+      } else if (root) {
+        return false;
+      } else {
+        ++leading_parents;
+      }
+    } else if (size > 0 && !(size == 1 && path[begin] == '.')) {
+      components.emplace_back(begin, size);
+    }
+    begin = end + 1;
+  }
+
+  Path result = path.substr(0, root);
+  for (size_t i = 0; i < leading_parents; ++i) {
+    result += i ? "/.." : "..";
+  }
+  for (const auto& component : components) {
+    if (result.size() > root) {
+      result += '/';
+    }
+    result.append(path, component.first, component.second);
+  }
+  if (result.empty()) {
+    result = ".";
+  }
+
+  path = std::move(result);
+  return true;
+}
+
+bool ResolvePath(const Path& path, const Path& dir, Path& result) {
+  if (RootSize(path)) {
+    result = path;
+  } else if (dir.empty()) {
+    result = path;
+  } else {
+    result.reserve(dir.size() + path.size() + 1);
+    result = dir;
+    if (result.back() != '/') {
+      result += '/';
+    }
+    result += path;
+  }
+  return NormalizePath(result);
+}
+
+}  // namespace shinobi
@@ -4,6 +4,16 @@
 
 namespace shinobi {
 
+// A file system path, or a source-absolute one, like "//src/base/base.cc".
 using Path = String;
 
+// Resolves "." and "..", and collapses the repeated and trailing slashes - in
+// place. Keeps the leading "/" or "//". Returns false, if ".." goes above the
+// root of an absolute path. The already normal paths aren't copied.
+bool NormalizePath(Path& path);
+
+// Makes the |path|, relative to the directory |dir|, absolute - if it isn't
+// yet - and normalizes it. Returns false, like |NormalizePath()|.
+bool ResolvePath(const Path& path, const Path& dir, Path& result);
+
 }  // namespace shinobi
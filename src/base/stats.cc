@@ -0,0 +1,165 @@
+#include <base/stats.hh>
+
+#include <base/assert.hh>
+#include <base/json.hh>
+
+#include STL(algorithm)
+#include STL(iomanip)
+#include STL(mutex)
+
+namespace shinobi {
+
+namespace {
+
+constexpr ui32 kMaxCounters = 1024;
+
+struct Registry {
+  std::mutex mutex;
+  Map<String, ui32> ids;
+  Vector<Pair<String, Stats::Unit>> counters;
+  List<std::atomic<ui64>*> live_slots;
+  Vector<ui64> retired = Vector<ui64>(kMaxCounters, 0);
+};
+
+Registry& registry() {
+  static Registry registry;
+  return registry;
+}
+
+// Merges the slots of a finished thread.
+struct ThreadSlotsHolder {
+  ~ThreadSlotsHolder() {
+    if (!slots) {
+      return;
+    }
+
+    auto& registry = shinobi::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ui32 i = 0; i < kMaxCounters; ++i) {
+      registry.retired[i] += slots[i].load(std::memory_order_relaxed);
+    }
+    registry.live_slots.remove(slots);
+    delete[] slots;
+  }
+
+  std::atomic<ui64>* slots = nullptr;
+};
+
+const char* PrintUnit(Stats::Unit unit) {
+  switch (unit) {
+    case Stats::COUNT:
+      return "";
+    case Stats::BYTES:
+      return "B";
+    case Stats::MICROSECONDS:
+      return "us";
+  }
+
+  NOTREACHED();
+  return "";
+}
+
+}  // namespace
+
+// static
+std::atomic<bool> Stats::enabled_(false);
+// static
+thread_local std::atomic<ui64>* Stats::thread_slots_ = nullptr;
+
+Stats::Counter::Counter(const String& name, Unit unit) {
+  auto& registry = shinobi::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  auto it = registry.ids.find(name);
+  if (it == registry.ids.end()) {
+    CHECK(registry.counters.size() < kMaxCounters);
+    it = registry.ids.emplace(name, registry.counters.size()).first;
+    registry.counters.emplace_back(name, unit);
+  }
+  id_ = it->second;
+}
+
+// static
+void Stats::Enable() {
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+// static
+void Stats::Print(std::ostream& stream, Format format) {
+  auto& registry = shinobi::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  Vector<ui64> values = registry.retired;
+  for (const auto* slots : registry.live_slots) {
+    for (ui32 i = 0; i < kMaxCounters; ++i) {
+      values[i] += slots[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  Vector<ui32> ids;
+  size_t width = 0;
+  for (ui32 i = 0; i < registry.counters.size(); ++i) {
+    if (values[i]) {
+      ids.push_back(i);
+      width = std::max(width, registry.counters[i].first.size());
+    }
+  }
+  std::sort(ids.begin(), ids.end(), [&registry](ui32 a, ui32 b) {
+    return registry.counters[a].first < registry.counters[b].first;
+  });
+
+  if (format == JSON) {
+    stream << "{";
+    for (size_t i = 0; i < ids.size(); ++i) {
+      const auto& counter = registry.counters[ids[i]];
+      stream << (i ? ",\n " : "\n ") << JsonString(counter.first) << ":{"
+             << "\"value\":" << values[ids[i]] << ",\"unit\":\""
+             << PrintUnit(counter.second) << "\"}";
+    }
+    stream << "\n}\n";
+    return;
+  }
+
+  for (auto id : ids) {
+    const auto& counter = registry.counters[id];
+    stream << std::left << std::setw(width + 2) << counter.first << std::right
+           << std::setw(14) << values[id];
+    if (counter.second != COUNT) {
+      stream << " " << PrintUnit(counter.second);
+    }
+    stream << "\n";
+  }
+}
+
+// static
+ui64 Stats::Get(const String& name) {
+  auto& registry = shinobi::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  auto it = registry.ids.find(name);
+  if (it == registry.ids.end()) {
+    return 0;
+  }
+
+  ui64 value = registry.retired[it->second];
+  for (const auto* slots : registry.live_slots) {
+    value += slots[it->second].load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+// static
+std::atomic<ui64>* Stats::CreateThreadSlots() {
+  static thread_local ThreadSlotsHolder holder;
+
+  holder.slots = new std::atomic<ui64>[kMaxCounters]();
+  {
+    auto& registry = shinobi::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.live_slots.push_back(holder.slots);
+  }
+  thread_slots_ = holder.slots;
+  return thread_slots_;
+}
+
+}  // namespace shinobi
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/attributes.hh>
+
+#include STL(atomic)
+#include STL(chrono)
+#include STL(ostream)
+
+namespace shinobi {
+
+// Registry of named counters. Each thread increments its own slots - without
+// any read-modify-write - and the slots are merged on read, including the ones
+// of finished threads. While disabled, a counter costs a single relaxed load.
+class Stats {
+ public:
+  enum Unit {
+    COUNT,
+    BYTES,
+    MICROSECONDS,
+  };
+
+  enum Format {
+    TABLE,
+    JSON,
+  };
+
+  // Cheap to copy handle. Counters with the same name are the same counter.
+  class Counter {
+   public:
+    explicit Counter(const String& name, Unit unit = COUNT);
+
+    inline void Add(ui64 value = 1) const {
+      if (enabled()) {
+        auto& slot = slots()[id_];
+        slot.store(slot.load(std::memory_order_relaxed) + value,
+                   std::memory_order_relaxed);
+      }
+    }
+
+   private:
+    ui32 id_;
+  };
+
+  // Adds its lifetime to the counter, which should be in |MICROSECONDS|.
+  class Timer {
+   public:
+    explicit Timer(const Counter& counter) : counter_(counter) {
+      if (enabled()) {
+        begin_ = std::chrono::steady_clock::now();
+      }
+    }
+
+    ~Timer() {
+      if (begin_ != std::chrono::steady_clock::time_point()) {
+        counter_.Add(std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - begin_)
+                         .count());
+      }
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+   private:
+    const Counter counter_;
+    std::chrono::steady_clock::time_point begin_;
+  };
+
+  THREAD_UNSAFE static void Enable();
+
+  inline static bool enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Prints the non-zero counters sorted by name.
+  THREAD_SAFE static void Print(std::ostream& stream, Format format);
+
+  // Merged value of all threads, or zero for an unknown counter.
+  THREAD_SAFE static ui64 Get(const String& name);
+
+ private:
+  inline static std::atomic<ui64>* slots() {
+    return thread_slots_ ? thread_slots_ : CreateThreadSlots();
+  }
+
+  static std::atomic<ui64>* CreateThreadSlots();
+
+  static std::atomic<bool> enabled_;
+  static thread_local std::atomic<ui64>* thread_slots_;
+};
+
+}  // namespace shinobi
@@ -0,0 +1,54 @@
+#include <base/stats.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(sstream)
+#include STL(thread)
+
+namespace shinobi {
+
+TEST(StatsTest, MergesThreads) {
+  Stats::Enable();
+
+  const Stats::Counter counter("test.merges_threads");
+  const Stats::Counter same_counter("test.merges_threads");
+
+  Vector<std::thread> threads;
+  for (ui32 i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      for (ui32 j = 0; j < 1000; ++j) {
+        counter.Add();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  same_counter.Add(5);
+
+  EXPECT_EQ(4005u, Stats::Get("test.merges_threads"));
+  EXPECT_EQ(0u, Stats::Get("test.unknown"));
+}
+
+TEST(StatsTest, Print) {
+  Stats::Enable();
+
+  Stats::Counter("test.print.\"bytes\"", Stats::BYTES).Add(42);
+  Stats::Counter("test.print.zero");
+
+  std::stringstream table;
+  Stats::Print(table, Stats::TABLE);
+  EXPECT_NE(String::npos, table.str().find("test.print.\"bytes\""));
+  EXPECT_NE(String::npos, table.str().find("42 B\n"));
+  EXPECT_EQ(String::npos, table.str().find("test.print.zero"));
+
+  std::stringstream json;
+  Stats::Print(json, Stats::JSON);
+  EXPECT_NE(String::npos,
+            json.str().find("\"test.print.\\\"bytes\\\"\":"
+                            "{\"value\":42,\"unit\":\"B\"}"));
+  EXPECT_EQ('{', json.str().front());
+}
+
+}  // namespace shinobi
@@ -0,0 +1,130 @@
+#include <base/thread_pool.hh>
+
+#include <base/assert.hh>
+#include <base/crash.hh>
+
+namespace shinobi {
+
+// static
+thread_local ThreadPool* ThreadPool::current_pool_ = nullptr;
+// static
+thread_local ui32 ThreadPool::current_index_ = 0;
+
+ThreadPool::ThreadPool(ui32 size) {
+  if (size == 0) {
+    size = 1;
+  }
+
+  for (ui32 i = 0; i < size; ++i) {
+    queues_.emplace_back(std::make_unique<Queue>());
+  }
+  for (ui32 i = 0; i < size; ++i) {
+    threads_.emplace_back(&ThreadPool::Run, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  worker_condition_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Push(Task task) {
+  ++pending_;
+
+  const ui32 index = current_pool_ == this
+                         ? current_index_
+                         : next_queue_.fetch_add(1) % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.emplace_back(std::move(task));
+    ++queued_;
+  }
+
+  // Don't let the notification slip between the check and the wait.
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  worker_condition_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  DCHECK(current_pool_ != this);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_condition_.wait(lock, [this] { return pending_ == 0; });
+
+  if (error_) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::Run(ui32 index) {
+  current_pool_ = this;
+  current_index_ = index;
+  Crash::PrepareThread();
+
+  while (true) {
+    Task task;
+    if (TryPop(index, task)) {
+      Execute(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    worker_condition_.wait(lock, [this] { return shutdown_ || queued_ > 0; });
+    if (shutdown_ && queued_ == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::TryPop(ui32 index, Task& task) {
+  {
+    auto& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      --queued_;
+      return true;
+    }
+  }
+
+  for (ui32 i = 1; i < queues_.size(); ++i) {
+    auto& queue = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      --queued_;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::Execute(Task& task) {
+  try {
+    task();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_) {
+      error_ = std::current_exception();
+    }
+  }
+
+  if (--pending_ == 0) {
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    done_condition_.notify_all();
+  }
+}
+
+}  // namespace shinobi
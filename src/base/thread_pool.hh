@@ -0,0 +1,63 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/attributes.hh>
+
+#include STL(atomic)
+#include STL(condition_variable)
+#include STL(deque)
+#include STL(functional)
+#include STL(mutex)
+#include STL(thread)
+
+namespace shinobi {
+
+// Each worker has its own queue: it takes the most recent tasks from the back
+// of its queue and steals the oldest tasks from the front of the others.
+// The tasks pushed from a worker go to its own queue.
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit ThreadPool(ui32 size = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  THREAD_SAFE void Push(Task task);
+
+  // Waits for all the tasks, including the ones pushed by other tasks.
+  // Rethrows the first exception thrown by any task. Shouldn't be called from
+  // the worker of this pool.
+  THREAD_SAFE void Wait();
+
+  inline ui32 size() const { return threads_.size(); }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Run(ui32 index);
+  bool TryPop(ui32 index, Task& task);
+  void Execute(Task& task);
+
+  Vector<UniquePtr<Queue>> queues_;
+  Vector<std::thread> threads_;
+
+  std::atomic<ui64> pending_{0};  // Pushed, but not yet executed.
+  std::atomic<ui64> queued_{0};   // Pushed, but not yet taken by a worker.
+  std::atomic<ui32> next_queue_{0};
+
+  std::mutex mutex_;
+  std::condition_variable worker_condition_, done_condition_;
+  bool shutdown_ = false;
+  std::exception_ptr error_;
+
+  static thread_local ThreadPool* current_pool_;
+  static thread_local ui32 current_index_;
+};
+
+}  // namespace shinobi
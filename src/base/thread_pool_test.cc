@@ -0,0 +1,43 @@
+#include <base/thread_pool.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+namespace shinobi {
+
+TEST(ThreadPoolTest, NestedTasks) {
+  ThreadPool pool(4);
+  std::atomic<ui32> counter(0);
+
+  for (ui32 i = 0; i < 100; ++i) {
+    pool.Push([&] {
+      ++counter;
+      for (ui32 j = 0; j < 10; ++j) {
+        pool.Push([&] { ++counter; });
+      }
+    });
+  }
+  pool.Wait();
+
+  EXPECT_EQ(1100u, counter);
+
+  // The pool is reusable after waiting.
+  pool.Push([&] { ++counter; });
+  pool.Wait();
+  EXPECT_EQ(1101u, counter);
+}
+
+TEST(ThreadPoolTest, RethrowException) {
+  ThreadPool pool(2);
+  std::atomic<ui32> counter(0);
+
+  pool.Push([] { throw std::runtime_error("task failed"); });
+  for (ui32 i = 0; i < 10; ++i) {
+    pool.Push([&] { ++counter; });
+  }
+
+  EXPECT_THROW(pool.Wait(), std::runtime_error);
+  EXPECT_EQ(10u, counter);
+}
+
+}  // namespace shinobi
@@ -0,0 +1,125 @@
+#include <base/tracing.hh>
+
+#include <base/json.hh>
+
+#include STL(chrono)
+#include STL(fstream)
+#include STL(mutex)
+
+#include <unistd.h>
+
+namespace shinobi {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Event {
+  const char* name;
+  ui64 begin, duration;
+  String detail;
+};
+
+// Only the owning thread appends, but the writer may read concurrently - the
+// mutex is never contended in practice.
+struct Buffer {
+  ui32 thread_id;
+  std::mutex mutex;
+  Vector<Event> events;
+};
+
+Clock::time_point start_time;
+
+std::mutex buffers_mutex;
+List<SharedPtr<Buffer>> buffers;
+
+Buffer& GetBuffer() {
+  // The buffers outlive their threads - to be written in the end.
+  static thread_local SharedPtr<Buffer> buffer;
+  if (!buffer) {
+    buffer = std::make_shared<Buffer>();
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    buffer->thread_id = buffers.size() + 1;
+    buffers.push_back(buffer);
+  }
+  return *buffer;
+}
+
+ui64 Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               start_time)
+      .count();
+}
+
+}  // namespace
+
+// static
+std::atomic<bool> Tracing::enabled_(false);
+
+void Tracing::Span::Start(const String* detail) {
+  started_ = true;
+  if (detail) {
+    detail_ = *detail;
+  }
+  begin_ = Now();
+}
+
+void Tracing::Span::Finish() {
+  const ui64 end = Now();
+  Buffer& buffer = GetBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.events.push_back(
+      Event{name_, begin_, end - begin_, std::move(detail_)});
+}
+
+// static
+void Tracing::Enable() {
+  start_time = Clock::now();
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+// static
+bool Tracing::Write(const Path& path) {
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    return false;
+  }
+
+  const auto pid = getpid();
+  bool first = true;
+  auto separator = [&] {
+    stream << (first ? "\n" : ",\n");
+    first = false;
+  };
+
+  stream << "{\"traceEvents\":[";
+
+  std::lock_guard<std::mutex> buffers_lock(buffers_mutex);
+  for (const auto& buffer : buffers) {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+
+    separator();
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":" << buffer->thread_id
+           << ",\"args\":{\"name\":\"thread " << buffer->thread_id << "\"}}";
+
+    for (const auto& event : buffer->events) {
+      separator();
+      stream << "{\"name\":" << JsonString(event.name)
+             << ",\"cat\":\"shinobi\",\"ph\":\"X\",\"ts\":" << event.begin
+             << ",\"dur\":" << event.duration << ",\"pid\":" << pid
+             << ",\"tid\":" << buffer->thread_id;
+      if (!event.detail.empty()) {
+        stream << ",\"args\":{\"detail\":" << JsonString(event.detail)
+               << "}";
+      }
+      stream << "}";
+    }
+  }
+
+  stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  stream.close();
+  return static_cast<bool>(stream);
+}
+
+}  // namespace shinobi
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/attributes.hh>
+#include <base/path.hh>
+
+#include STL(atomic)
+
+namespace shinobi {
+
+// Records the scoped spans into per-thread buffers and writes them as Chrome
+// trace-event JSON - viewable in chrome://tracing or Perfetto. While tracing is
+// disabled, a span costs a single relaxed load.
+class Tracing {
+ public:
+  class Span {
+   public:
+    // |name| should outlive the tracing - e.g. be a string literal.
+    explicit Span(const char* name) : name_(name) {
+      if (enabled()) {
+        Start(nullptr);
+      }
+    }
+
+    // |detail| is copied only while tracing is enabled.
+    Span(const char* name, const String& detail) : name_(name) {
+      if (enabled()) {
+        Start(&detail);
+      }
+    }
+
+    ~Span() {
+      if (started_) {
+        Finish();
+      }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+   private:
+    void Start(const String* detail);
+    void Finish();
+
+    const char* name_;
+    bool started_ = false;
+    ui64 begin_ = 0;  // In microseconds since |Enable()|.
+    String detail_;
+  };
+
+  THREAD_UNSAFE static void Enable();
+
+  inline static bool enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Should be called when all the spans are finished. Returns false, if the
+  // file can't be written.
+  THREAD_SAFE static bool Write(const Path& path);
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace shinobi
@@ -0,0 +1,42 @@
+#include <base/tracing.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+#include STL(sstream)
+#include STL(thread)
+
+#include <unistd.h>
+
+namespace shinobi {
+
+TEST(TracingTest, WritesSpansOfAllThreads) {
+  Tracing::Enable();
+
+  { Tracing::Span span("Main", "quoted \"detail\"\n"); }
+  std::thread([] { Tracing::Span span("Worker"); }).join();
+
+  char path[] = "/tmp/shinobi_trace_XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_NE(-1, fd);
+  close(fd);
+
+  ASSERT_TRUE(Tracing::Write(path));
+
+  std::ifstream stream(path);
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  unlink(path);
+
+  const String json = contents.str();
+  EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+  EXPECT_NE(String::npos, json.find("\"name\":\"Main\",\"cat\":\"shinobi\","
+                                    "\"ph\":\"X\""));
+  EXPECT_NE(String::npos, json.find("\"args\":{\"detail\":"
+                                    "\"quoted \\\"detail\\\"\\u000a\"}"));
+  EXPECT_NE(String::npos, json.find("\"name\":\"Worker\""));
+  EXPECT_NE(String::npos, json.find("\"ph\":\"M\""));
+}
+
+}  // namespace shinobi
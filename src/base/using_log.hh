@@ -13,9 +13,21 @@
 
 using namespace shinobi::named_levels;
 
-#define LOG(level) shinobi::Log(level)
+// The most verbose level, which isn't compiled out.
+#if !defined(COMPILED_LOG_LEVEL)
+#define COMPILED_LOG_LEVEL TRACE
+#endif
+
+// Arguments of a filtered-out message are never evaluated. The messages above
+// |COMPILED_LOG_LEVEL| are eliminated by the compiler altogether.
+#define LOG(level)                                                   \
+  !((level) <= COMPILED_LOG_LEVEL && shinobi::Log::IsEnabled(level)) \
+      ? (void)0                                                      \
+      : shinobi::Log::Voidify() & shinobi::Log(level)
+
 #if defined(NDEBUG)
-#define DLOG(level) std::stringstream()
+#define DLOG(level) \
+  true ? (void)0 : shinobi::Log::Voidify() & shinobi::Log(level)
 #else
 #define DLOG(level) LOG(level)
 #endif
@@ -0,0 +1,34 @@
+#include <daemon/client.hh>
+
+#include <daemon/protocol.hh>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace shinobi::daemon {
+
+// static
+bool Client::Run(const Path& socket_path, const Generator::Request& request,
+                 bool& success, Vector<String>& messages) {
+  sockaddr_un address;
+  if (!Protocol::MakeAddress(socket_path, address)) {
+    return false;
+  }
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return false;
+  }
+
+  String response;
+  const bool answered =
+      connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) ==
+          0 &&
+      Protocol::WriteAll(fd, Protocol::EncodeRequest(request)) &&
+      shutdown(fd, SHUT_WR) == 0 && Protocol::ReadAll(fd, response);
+  close(fd);
+
+  return answered && Protocol::DecodeResponse(response, success, messages);
+}
+
+}  // namespace shinobi::daemon
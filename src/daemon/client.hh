@@ -0,0 +1,15 @@
+#pragma once
+
+#include <daemon/generator.hh>
+
+namespace shinobi::daemon {
+
+class Client {
+ public:
+  // Runs the request by the daemon, listening on |socket_path|. Returns false,
+  // if there's no daemon - then the request should be run in-process.
+  static bool Run(const Path& socket_path, const Generator::Request& request,
+                  bool& success, Vector<String>& messages);
+};
+
+}  // namespace shinobi::daemon
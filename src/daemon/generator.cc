@@ -0,0 +1,376 @@
+#include <daemon/generator.hh>
+
+#include <base/file_system.hh>
+#include <base/memory.hh>
+#include <base/tracing.hh>
+#include <graph/builder.hh>
+#include <graph/header_checker.hh>
+#include <incremental/database.hh>
+#include <language/shi/session.hh>
+#include <output/compile_commands_writer.hh>
+#include <output/ninja_writer.hh>
+
+#include STL(algorithm)
+
+namespace shinobi::daemon {
+
+namespace {
+
+constexpr const char* kBuildFileName = "BUILD.shi";
+
+// Finds all the build files, skipping the hidden directories and the build
+// directories. The directories are listed in parallel, so the results are
+// unordered.
+void FindBuildFiles(ThreadPool& pool, const Path& dir_path,
+                    const Vector<Path>& skip, std::mutex& mutex,
+                    Vector<Path>& build_files) {
+  Vector<FileSystem::Entry> entries;
+  if (!FileSystem::List(dir_path, entries)) {
+    return;
+  }
+
+  for (const auto& entry : entries) {
+    if (entry.name.empty() || entry.name[0] == '.') {
+      continue;
+    }
+
+    const Path path = dir_path + "/" + entry.name;
+    if (entry.is_dir) {
+      if (std::find(skip.begin(), skip.end(), path) == skip.end()) {
+        pool.Push([&pool, path, &skip, &mutex, &build_files] {
+          FindBuildFiles(pool, path, skip, mutex, build_files);
+        });
+      }
+    } else if (entry.name == kBuildFileName) {
+      std::lock_guard<std::mutex> lock(mutex);
+      build_files.push_back(path);
+    }
+  }
+}
+
+// The build directory of the configuration, like "out/Debug".
+String ConfigurationName(const String& argument) {
+  return argument.substr(0, argument.find(':', 2));
+}
+
+// Parses the configuration like "out/Debug:is_debug=true version=\"1.0\"".
+language::shi::Configuration ParseConfiguration(const String& argument) {
+  using namespace language::shi;
+
+  Configuration configuration;
+  const auto colon = argument.find(':', 2);
+  configuration.name = ConfigurationName(argument);
+
+  if (colon != String::npos) {
+    auto file = Loader::Parse("<args>", argument.substr(colon + 1));
+    Scope scope;
+    Evaluator().Execute(file->root.get(), scope);
+    configuration.args = scope.values();
+  }
+
+  return configuration;
+}
+
+}  // namespace
+
+Generator::Generator(const Path& source_root, ui32 threads)
+    : source_root_(source_root),
+      pool_(threads ? threads : std::thread::hardware_concurrency()) {}
+
+Vector<Path> Generator::BuildDirs(const Request& request) const {
+  Vector<Path> build_dirs;
+  for (const auto& argument : request.arguments) {
+    build_dirs.push_back(
+        SourcePath(ConfigurationName(argument), request.working_dir));
+  }
+  return build_dirs;
+}
+
+Vector<String> Generator::Run(const Request& request) {
+  Vector<language::shi::Configuration> configurations;
+  for (const auto& argument : request.arguments) {
+    configurations.push_back(ParseConfiguration(argument));
+  }
+  const Vector<Path> build_dirs = BuildDirs(request);
+  const Path build_config =
+      SourcePath(request.build_config, request.working_dir);
+
+  Vector<String> keys;
+  for (const auto& argument : request.arguments) {
+    keys.push_back(build_config + '\0' + argument + '\0' +
+                   (request.export_compile_commands ? "1" : "0"));
+  }
+
+  // Nothing changed since the engines were built - so the run wouldn't change
+  // the build directories either. The headers are always checked.
+  if (!request.queries.empty() && !request.check_headers) {
+    std::lock_guard<std::mutex> lock(queries_mutex_);
+    bool cached = true;
+    for (size_t i = 0; i < build_dirs.size() && cached; ++i) {
+      auto it = queries_.find(build_dirs[i]);
+      cached = it != queries_.end() && it->second->key == keys[i];
+    }
+
+    if (cached) {
+      Vector<String> summary;
+      for (size_t i = 0; i < build_dirs.size(); ++i) {
+        const auto& queries = *queries_.at(build_dirs[i]);
+        summary.push_back("Up to date: " +
+                          std::to_string(queries.graph->size()) +
+                          " targets in " + build_dirs[i]);
+        RunQueries(queries, request, build_dirs[i], summary);
+      }
+      return summary;
+    }
+  }
+
+  Vector<Path> build_files;
+  {
+    Tracing::Span span("FindBuildFiles");
+    Memory::Phase phase("find");
+    std::mutex mutex;
+    pool_.Push([&] {
+      FindBuildFiles(pool_, source_root_, build_dirs, mutex, build_files);
+    });
+    pool_.Wait();
+    std::sort(build_files.begin(), build_files.end());
+  }
+
+  // Restore the results of the previous run - and don't evaluate the build
+  // files, which inputs didn't change.
+  Vector<incremental::Database> databases(configurations.size());
+  Map<String, std::unordered_set<Path>> up_to_date;
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    Tracing::Span span("Database::Check", configurations[i].name);
+    auto& files = up_to_date[configurations[i].name];
+    databases[i].Load(
+        build_dirs[i] + "/" + kDatabaseName,
+        language::shi::Optimizer(configurations[i].args).fingerprint());
+    FileSystem::Prefetch(databases[i].inputs(), pool_);
+    for (const auto& build_file : build_files) {
+      if (databases[i].IsUpToDate(build_file)) {
+        files.insert(build_file);
+      }
+    }
+  }
+
+  // A separate graph builder for each configuration.
+  std::mutex mutex;
+  Map<String, UniquePtr<graph::Builder>> builders;
+  language::shi::Session session(
+      loader_,
+      [&](const language::shi::Configuration& configuration,
+          language::shi::Evaluator& evaluator) {
+        auto builder = std::make_unique<graph::Builder>(source_root_);
+        builder->Register(evaluator);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        builders[configuration.name] = std::move(builder);
+      },
+      [&](const language::shi::Configuration& configuration,
+          const Path& build_file) {
+        return !up_to_date.at(configuration.name).count(build_file);
+      },
+      source_root_);
+
+  Vector<UniquePtr<language::shi::Session::Result>> results;
+  {
+    Memory::Phase phase("evaluate");
+    results = session.Evaluate(build_config, build_files, configurations);
+  }
+
+  Vector<String> summary;
+  Vector<graph::HeaderChecker::Error> include_errors;
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    Tracing::Span span("Generate", configurations[i].name);
+    auto& database = databases[i];
+    const auto& files = up_to_date[configurations[i].name];
+
+    auto& builder = *builders[configurations[i].name];
+    for (const auto& build_file : files) {
+      for (const auto& target : database.targets(build_file)) {
+        builder.Add(graph::Target(target));
+      }
+    }
+    Memory::Phase phase("generate");
+    auto graph = builder.Build();
+
+    Map<Path, Vector<const graph::Target*>> targets;
+    for (graph::Graph::Index j = 0; j < graph->size(); ++j) {
+      const auto& target = graph->target(j);
+      targets[target.location().file_path()].push_back(&target);
+    }
+    // The build file depends on the files it imports - and on the ones,
+    // imported by the build config.
+    // The stamps are of the contents, that were evaluated - the files are
+    // taken from the loader.
+    auto& imports = results[i]->imports;
+    for (const auto& build_file : build_files) {
+      if (!files.count(build_file)) {
+        Vector<Path> paths = {build_config, build_file};
+        for (const auto* file : {&build_config, &build_file}) {
+          paths.insert(paths.end(), imports[*file].begin(),
+                       imports[*file].end());
+        }
+
+        using Stamp = incremental::Database::Stamp;
+        Vector<Pair<Path, Stamp>> inputs;
+        for (const auto& path : paths) {
+          const auto file = loader_.Load(path);
+          auto& stamp = inputs.emplace_back(path, Stamp()).second;
+          stamp.size = file->info.size;
+          stamp.mtime = file->info.mtime;
+          stamp.hash = file->hash;
+        }
+        database.Record(build_file, inputs, targets[build_file]);
+      }
+    }
+    database.Retain(build_files);
+
+    output::NinjaWriter::Options options;
+    options.source_root = source_root_;
+    options.build_dir = build_dirs[i];
+
+    auto changed = output::NinjaWriter(*graph, options).Write(pool_);
+    if (request.export_compile_commands &&
+        output::CompileCommandsWriter(*graph, options).Write(pool_)) {
+      ++changed;
+    }
+    database.Save(build_dirs[i] + "/" + kDatabaseName);
+
+    if (request.check_headers) {
+      auto errors = graph::HeaderChecker(*graph, source_root_).Check(pool_);
+      std::move(errors.begin(), errors.end(),
+                std::back_inserter(include_errors));
+    }
+
+    summary.push_back("Generated " + std::to_string(graph->size()) +
+                      " targets in " + build_dirs[i] + ": " +
+                      std::to_string(build_files.size() - files.size()) +
+                      " build files evaluated, " + std::to_string(changed) +
+                      " files changed");
+
+    // The engine is rebuilt only after the runs with queries - the others
+    // may change the build directory.
+    std::lock_guard<std::mutex> lock(queries_mutex_);
+    queries_.erase(build_dirs[i]);
+    if (!request.queries.empty()) {
+      auto queries = std::make_unique<Queries>();
+      queries->key = keys[i];
+      auto inputs = database.inputs();
+      std::sort(inputs.begin(), inputs.end());
+      for (const auto& input : inputs) {
+        for (Path path = input; !queries->inputs.count(path);) {
+          queries->inputs.insert(path);
+          const auto slash = path.rfind('/');
+          if (slash == String::npos || slash == 0) {
+            break;
+          }
+          path.resize(slash);
+        }
+      }
+      queries->files = LoadFiles(inputs);
+      queries->graph = std::move(graph);
+      queries->engine =
+          std::make_unique<query::Engine>(*queries->graph, queries->files);
+
+      // Kept even if a query is wrong.
+      const auto& kept = *(queries_[build_dirs[i]] = std::move(queries));
+      RunQueries(kept, request, build_dirs[i], summary);
+    }
+  }
+
+  if (!include_errors.empty()) {
+    String message =
+        std::to_string(include_errors.size()) + " header check errors:";
+    for (const auto& error : include_errors) {
+      message += "\n" + error.message + "\n  at " +
+                 error.location.file_path() + ":" +
+                 std::to_string(error.location.line()) + ":" +
+                 std::to_string(error.location.column());
+    }
+    throw graph::GraphError(message, {});
+  }
+
+  return summary;
+}
+
+void Generator::Invalidate(const Path& path) {
+  FileSystem::Invalidate(path);
+  loader_.Invalidate(path);
+
+  // A new build file isn't an input yet. A moved directory is reported alone
+  // - without its files.
+  const auto slash = path.rfind('/');
+  const bool is_build_file =
+      path.compare(slash + 1, String::npos, kBuildFileName) == 0;
+
+  std::lock_guard<std::mutex> lock(queries_mutex_);
+  for (auto it = queries_.begin(); it != queries_.end();) {
+    if (is_build_file || it->second->inputs.count(path)) {
+      it = queries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void Generator::InvalidateAll() {
+  FileSystem::InvalidateAll();
+  loader_.Clear();
+
+  std::lock_guard<std::mutex> lock(queries_mutex_);
+  queries_.clear();
+}
+
+// static
+void Generator::RunQueries(const Queries& queries, const Request& request,
+                           const Path& build_dir, Vector<String>& summary) {
+  for (const auto& query : request.queries) {
+    summary.push_back(query + " in " + build_dir + ":");
+    for (const auto& result : queries.engine->Run(query)) {
+      summary.push_back("  " + result);
+    }
+  }
+}
+
+Vector<language::shi::Loader::FilePtr> Generator::LoadFiles(
+    const Vector<Path>& paths) {
+  Vector<language::shi::Loader::FilePtr> files(paths.size());
+  std::mutex mutex;
+  std::exception_ptr error;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    pool_.Push([this, i, &paths, &files, &mutex, &error] {
+      try {
+        files[i] = loader_.Load(paths[i]);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::current_exception();
+      }
+    });
+  }
+  pool_.Wait();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return files;
+}
+
+Path Generator::SourcePath(const Path& path, const Path& working_dir) const {
+  Path result;
+  if (path.compare(0, 2, "//") == 0) {
+    result = source_root_ + "/" + path.substr(2);
+  } else if (!path.empty() && path[0] == '/') {
+    result = path;
+  } else {
+    result = working_dir + "/" + path;
+  }
+
+  // Like "./out" or "out/" - the build directory is compared with the listed
+  // ones, and its depth gives the prefix of the source paths.
+  NormalizePath(result);
+  return result;
+}
+
+}  // namespace shinobi::daemon
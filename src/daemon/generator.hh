@@ -0,0 +1,79 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <base/thread_pool.hh>
+#include <language/shi/loader.hh>
+#include <query/engine.hh>
+
+#include STL(mutex)
+#include STL(unordered_set)
+
+namespace shinobi::daemon {
+
+// The whole run: finds the build files, evaluates the changed ones for every
+// configuration and writes the Ninja files. Keeps the loaded files between the
+// runs - so a resident generator re-reads and re-parses only the files, that
+// were invalidated since. Keeps the query engines too: while none of their
+// inputs is invalidated, the queries are answered without a run.
+class Generator {
+ public:
+  struct Request {
+    Path working_dir;          // For the relative build directories.
+    Path build_config;         // Like "//build/config/BUILDCONFIG.shi".
+    Vector<String> arguments;  // Like "//out/Debug:is_debug=true".
+    bool check_headers = false;  // See |graph::HeaderChecker|.
+    bool export_compile_commands = false;
+    Vector<String> queries;  // See |query::Engine|.
+  };
+
+  // Saved in every build directory - it marks them as not the sources.
+  static constexpr const char* kDatabaseName = ".shinobi_db";
+
+  // Uses all the cores, if |threads| is zero.
+  Generator(const Path& source_root, ui32 threads);
+
+  // Returns the summary of each build directory, followed by the results of
+  // the queries. Throws on errors - including the disallowed includes, after
+  // the Ninja files are written.
+  THREAD_UNSAFE Vector<String> Run(const Request& request);
+
+  // The build directories of the request, written by its run.
+  THREAD_SAFE Vector<Path> BuildDirs(const Request& request) const;
+
+  // Forgets the cached contents and stat info of the changed file - and the
+  // query engines, which depend on it.
+  THREAD_SAFE void Invalidate(const Path& path);
+  THREAD_SAFE void InvalidateAll();
+
+  inline const Path& source_root() const { return source_root_; }
+
+ private:
+  // The engine of a build directory, with everything it refers to.
+  struct Queries {
+    String key;  // The build config, the arguments and the options.
+    std::unordered_set<Path> inputs;  // With all their directories.
+    UniquePtr<graph::Graph> graph;
+    Vector<language::shi::Loader::FilePtr> files;
+    UniquePtr<query::Engine> engine;
+  };
+
+  // Appends the results of the queries in the build directory.
+  static void RunQueries(const Queries& queries, const Request& request,
+                         const Path& build_dir, Vector<String>& summary);
+
+  // Resolves the paths like "//out/Debug" against the source root, and the
+  // relative ones against the |working_dir|. The result is normalized.
+  Path SourcePath(const Path& path, const Path& working_dir) const;
+
+  // Loads the files in parallel - mostly just takes them from the loader.
+  Vector<language::shi::Loader::FilePtr> LoadFiles(const Vector<Path>& paths);
+
+  const Path source_root_;
+  ThreadPool pool_;
+  language::shi::Loader loader_;
+
+  std::mutex queries_mutex_;
+  Map<Path, UniquePtr<Queries>> queries_;  // By the build directory.
+};
+
+}  // namespace shinobi::daemon
@@ -0,0 +1,106 @@
+#include <base/file_system.hh>
+#include <daemon/generator.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+#include STL(sstream)
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace shinobi::daemon {
+
+class GeneratorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/generator_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    dir = temp_dir;
+
+    ASSERT_EQ(0, mkdir((dir + "/src").c_str(), 0755));
+    ASSERT_EQ(0, mkdir((dir + "/out").c_str(), 0755));
+    Write("BUILDCONFIG.shi", "");
+    Write("src/BUILD.shi",
+          "source_set(\"src\") {\n"
+          "  sources = [ \"main.cc\" ]\n"
+          "}\n");
+    // Inside the build directory - shouldn't be found.
+    Write("out/BUILD.shi", "group(\"out\") {\n}\n");
+
+    request.working_dir = dir;
+    request.build_config = "//BUILDCONFIG.shi";
+  }
+
+  void TearDown() override {
+    FileSystem::InvalidateAll();
+    ASSERT_EQ(0, system(("rm -rf " + dir).c_str()));
+  }
+
+  void Write(const String& name, const String& contents) {
+    std::ofstream(dir + "/" + name) << contents;
+  }
+
+  String Read(const String& name) {
+    std::ifstream stream(dir + "/" + name);
+    std::stringstream contents;
+    contents << stream.rdbuf();
+    return contents.str();
+  }
+
+  Path dir;
+  Generator::Request request;
+};
+
+TEST_F(GeneratorTest, NormalizesBuildDirs) {
+  for (const char* build_dir : {"./out", "out/", "src/../out"}) {
+    request.arguments = {build_dir};
+    const auto summary = Generator(dir, 2).Run(request);
+    ASSERT_EQ(1u, summary.size());
+    // The build file in the build directory is skipped.
+    EXPECT_EQ(0u, summary[0].find("Generated 1 targets in " + dir + "/out: "))
+        << summary[0];
+    EXPECT_NE(String::npos,
+              Read("out/obj/src/src.ninja").find(": cxx ../src/main.cc"))
+        << build_dir;
+  }
+}
+
+TEST_F(GeneratorTest, KeepsQueryEngines) {
+  request.arguments = {"out"};
+  request.queries = {"owners //src/main.cc"};
+  Generator generator(dir, 2);
+
+  auto summary = generator.Run(request);
+  ASSERT_EQ(3u, summary.size());
+  EXPECT_EQ(0u, summary[0].find("Generated 1 targets in ")) << summary[0];
+  EXPECT_EQ("  //src:src", summary[2]);
+
+  // Not an input - the engine is still up to date.
+  Write("src/main.cc", "int main() {}\n");
+  generator.Invalidate(dir + "/src/main.cc");
+  summary = generator.Run(request);
+  ASSERT_EQ(3u, summary.size());
+  EXPECT_EQ("Up to date: 1 targets in " + dir + "/out", summary[0]);
+  EXPECT_EQ("  //src:src", summary[2]);
+
+  Write("src/BUILD.shi",
+        "source_set(\"app\") {\n"
+        "  sources = [ \"main.cc\" ]\n"
+        "}\n");
+  generator.Invalidate(dir + "/src/BUILD.shi");
+  summary = generator.Run(request);
+  ASSERT_EQ(3u, summary.size());
+  EXPECT_EQ(0u, summary[0].find("Generated 1 targets in ")) << summary[0];
+  EXPECT_EQ("  //src:app", summary[2]);
+
+  // The runs without queries may change the build directory.
+  request.queries.clear();
+  generator.Run(request);
+  request.queries = {"owners //src/main.cc"};
+  summary = generator.Run(request);
+  EXPECT_EQ(0u, summary[0].find("Generated 1 targets in ")) << summary[0];
+}
+
+}  // namespace shinobi::daemon
@@ -0,0 +1,142 @@
+#include <daemon/protocol.hh>
+
+#include STL(cstdlib)
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace shinobi::daemon {
+
+// static
+String Protocol::EncodeRequest(const Generator::Request& request) {
+  String data = request.working_dir + '\0' + request.build_config + '\0';
+  if (request.check_headers) {
+    data += 'c';
+  }
+  if (request.export_compile_commands) {
+    data += 'e';
+  }
+  data += '\0' + std::to_string(request.queries.size()) + '\0';
+  for (const auto& query : request.queries) {
+    data += query + '\0';
+  }
+  for (const auto& argument : request.arguments) {
+    data += argument + '\0';
+  }
+  return data;
+}
+
+// static
+bool Protocol::DecodeRequest(const String& data, Generator::Request& request) {
+  Vector<String> fields;
+  size_t begin = 0;
+  while (begin < data.size()) {
+    const auto end = data.find('\0', begin);
+    if (end == String::npos) {
+      return false;
+    }
+    fields.push_back(data.substr(begin, end - begin));
+    begin = end + 1;
+  }
+
+  if (fields.size() < 4) {
+    return false;
+  }
+
+  char* end;
+  const auto query_count = std::strtoul(fields[3].c_str(), &end, 10);
+  if (*end || fields[3].empty() || query_count > fields.size() - 4) {
+    return false;
+  }
+
+  request.working_dir = fields[0];
+  request.build_config = fields[1];
+  request.check_headers = fields[2].find('c') != String::npos;
+  request.export_compile_commands = fields[2].find('e') != String::npos;
+  request.queries.assign(fields.begin() + 4, fields.begin() + 4 + query_count);
+  request.arguments.assign(fields.begin() + 4 + query_count, fields.end());
+  return true;
+}
+
+// static
+String Protocol::EncodeResponse(bool success,
+                                const Vector<String>& messages) {
+  String data = success ? "0" : "1";
+  for (const auto& message : messages) {
+    data += message + '\n';
+  }
+  return data;
+}
+
+// static
+bool Protocol::DecodeResponse(const String& data, bool& success,
+                              Vector<String>& messages) {
+  if (data.empty() || (data[0] != '0' && data[0] != '1')) {
+    return false;
+  }
+
+  success = data[0] == '0';
+  messages.clear();
+  size_t begin = 1;
+  while (begin < data.size()) {
+    auto end = data.find('\n', begin);
+    if (end == String::npos) {
+      end = data.size();
+    }
+    messages.push_back(data.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return true;
+}
+
+// static
+bool Protocol::MakeAddress(const Path& socket_path, sockaddr_un& address) {
+  address = {};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+  return true;
+}
+
+// static
+bool Protocol::ReadAll(int fd, String& data) {
+  char buffer[16 * 1024];
+  while (true) {
+    const ssize_t size = read(fd, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    if (size < 0) {
+      return false;
+    }
+    if (size == 0) {
+      return true;
+    }
+    data.append(buffer, size);
+  }
+}
+
+// static
+bool Protocol::WriteAll(int fd, const String& data) {
+  const char* begin = data.data();
+  size_t size = data.size();
+  while (size) {
+    // A client, that went away, shouldn't kill the daemon with SIGPIPE.
+    const ssize_t written = send(fd, begin, size, MSG_NOSIGNAL);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    begin += written;
+    size -= written;
+  }
+  return true;
+}
+
+}  // namespace shinobi::daemon
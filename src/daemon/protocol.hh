@@ -0,0 +1,35 @@
+#pragma once
+
+#include <daemon/generator.hh>
+
+#include <sys/un.h>
+
+namespace shinobi::daemon {
+
+// The client writes the request and shuts down its side of the socket, then
+// the daemon writes the response and closes the connection:
+//
+//   request:  <working dir>\0<build config>\0<options>\0<query count>\0
+//             <query>\0...<argument>\0...
+//   response: <'0' on success, '1' on failure><message>\n...
+//
+// The options are a letter each: 'c' to check the includes, 'e' to export the
+// compilation database.
+class Protocol {
+ public:
+  static String EncodeRequest(const Generator::Request& request);
+  static bool DecodeRequest(const String& data, Generator::Request& request);
+
+  static String EncodeResponse(bool success, const Vector<String>& messages);
+  static bool DecodeResponse(const String& data, bool& success,
+                             Vector<String>& messages);
+
+  // Returns false, if the path is too long for a Unix socket.
+  static bool MakeAddress(const Path& socket_path, sockaddr_un& address);
+
+  // Reads the socket until the end of the stream. Return false on errors.
+  static bool ReadAll(int fd, String& data);
+  static bool WriteAll(int fd, const String& data);
+};
+
+}  // namespace shinobi::daemon
@@ -0,0 +1,184 @@
+#include <daemon/server.hh>
+
+#include <base/logging.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <daemon/protocol.hh>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <base/using_log.hh>
+
+namespace shinobi::daemon {
+
+namespace {
+
+const Stats::Counter requests_served("daemon.requests");
+const Stats::Counter files_invalidated("daemon.files_invalidated");
+const Stats::Counter clients_dropped("daemon.clients_dropped");
+
+}  // namespace
+
+Server::Server(Generator& generator, Watcher& watcher,
+               std::chrono::milliseconds client_timeout)
+    : generator_(generator),
+      watcher_(watcher),
+      client_timeout_(client_timeout) {
+  if (pipe2(stop_fds_, O_CLOEXEC) == -1) {
+    stop_fds_[0] = stop_fds_[1] = -1;
+  }
+}
+
+Server::~Server() {
+  if (socket_fd_ != -1) {
+    close(socket_fd_);
+    unlink(socket_path_.c_str());
+  }
+  for (int fd : stop_fds_) {
+    if (fd != -1) {
+      close(fd);
+    }
+  }
+}
+
+bool Server::Listen(const Path& socket_path) {
+  sockaddr_un address;
+  if (!Protocol::MakeAddress(socket_path, address) || stop_fds_[0] == -1) {
+    return false;
+  }
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return false;
+  }
+
+  auto* generic_address = reinterpret_cast<sockaddr*>(&address);
+  if (bind(fd, generic_address, sizeof(address)) == -1) {
+    // Nobody answers on the stale socket.
+    if (errno != EADDRINUSE ||
+        connect(fd, generic_address, sizeof(address)) == 0 ||
+        unlink(socket_path.c_str()) == -1 ||
+        bind(fd, generic_address, sizeof(address)) == -1) {
+      close(fd);
+      return false;
+    }
+  }
+
+  if (listen(fd, 16) == -1) {
+    close(fd);
+    unlink(socket_path.c_str());
+    return false;
+  }
+
+  socket_fd_ = fd;
+  socket_path_ = socket_path;
+  return true;
+}
+
+void Server::Serve() {
+  while (true) {
+    pollfd fds[] = {
+        {socket_fd_, POLLIN, 0},
+        {watcher_.fd(), POLLIN, 0},
+        {stop_fds_[0], POLLIN, 0},
+    };
+    if (poll(fds, 3, -1) == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "Failed to wait for the clients: " << strerror(errno);
+      return;
+    }
+
+    if (fds[2].revents) {
+      return;
+    }
+    if (fds[1].revents) {
+      ApplyChanges();
+    }
+    if (fds[0].revents & POLLIN) {
+      const int client_fd = accept4(socket_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (client_fd != -1) {
+        Handle(client_fd);
+        close(client_fd);
+      }
+    }
+  }
+}
+
+void Server::Stop() {
+  const char byte = 0;
+  while (write(stop_fds_[1], &byte, 1) == -1 && errno == EINTR) {
+  }
+}
+
+void Server::ApplyChanges() {
+  Vector<Path> changed;
+  if (!watcher_.ReadEvents(changed)) {
+    LOG(INFO) << "Lost the file system events - forgetting everything";
+    generator_.InvalidateAll();
+    return;
+  }
+
+  for (const auto& path : changed) {
+    generator_.Invalidate(path);
+  }
+  files_invalidated.Add(changed.size());
+}
+
+void Server::Handle(int client_fd) {
+  Tracing::Span span("Server::Handle");
+  requests_served.Add();
+
+  // A stalled client shouldn't block the others.
+  const timeval timeout = {
+      time_t(client_timeout_.count() / 1000),
+      suseconds_t(client_timeout_.count() % 1000 * 1000)};
+  for (int option : {SO_RCVTIMEO, SO_SNDTIMEO}) {
+    setsockopt(client_fd, SOL_SOCKET, option, &timeout, sizeof(timeout));
+  }
+
+  String data;
+  if (!Protocol::ReadAll(client_fd, data)) {
+    LOG(WARNING) << "Dropped the client: " << strerror(errno);
+    clients_dropped.Add();
+    return;
+  }
+
+  Generator::Request request;
+  if (!Protocol::DecodeRequest(data, request)) {
+    Protocol::WriteAll(client_fd,
+                       Protocol::EncodeResponse(false, {"Invalid request"}));
+    return;
+  }
+
+  // The build directories are rewritten by every run - they aren't sources.
+  for (const auto& build_dir : generator_.BuildDirs(request)) {
+    watcher_.Ignore(build_dir);
+  }
+
+  // The changes, made right before the request, should be seen by it.
+  ApplyChanges();
+
+  bool success = true;
+  Vector<String> messages;
+  try {
+    messages = generator_.Run(request);
+  } catch (const std::exception& error) {
+    success = false;
+    messages = {error.what()};
+  }
+
+  for (const auto& message : messages) {
+    LOG(INFO) << message;
+  }
+  Protocol::WriteAll(client_fd, Protocol::EncodeResponse(success, messages));
+}
+
+}  // namespace shinobi::daemon
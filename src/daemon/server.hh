@@ -0,0 +1,46 @@
+#pragma once
+
+#include <daemon/generator.hh>
+#include <daemon/watcher.hh>
+
+#include STL(atomic)
+#include STL(chrono)
+
+namespace shinobi::daemon {
+
+// Serves the runs of the clients over a Unix socket - one at a time. The
+// files, reported by the watcher, are invalidated before each run, so only
+// they are read and parsed again. The clients, that don't send the request or
+// don't read the response in |client_timeout|, are dropped.
+class Server {
+ public:
+  static constexpr std::chrono::milliseconds kClientTimeout{5000};
+
+  Server(Generator& generator, Watcher& watcher,
+         std::chrono::milliseconds client_timeout = kClientTimeout);
+  ~Server();
+
+  Server(const Server&) = delete;
+  Server& operator=(const Server&) = delete;
+
+  // Returns false, if the socket is taken by a running daemon, or can't be
+  // created. The stale socket of a finished daemon is replaced.
+  THREAD_UNSAFE bool Listen(const Path& socket_path);
+
+  // Returns after |Stop()|.
+  THREAD_UNSAFE void Serve();
+  THREAD_SAFE void Stop();
+
+ private:
+  void ApplyChanges();
+  void Handle(int client_fd);
+
+  Generator& generator_;
+  Watcher& watcher_;
+  const std::chrono::milliseconds client_timeout_;
+  Path socket_path_;
+  int socket_fd_ = -1;
+  int stop_fds_[2] = {-1, -1};  // A pipe to wake up |Serve()|.
+};
+
+}  // namespace shinobi::daemon
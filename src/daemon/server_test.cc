@@ -0,0 +1,122 @@
+#include <base/file_system.hh>
+#include <daemon/client.hh>
+#include <daemon/protocol.hh>
+#include <daemon/server.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+#include STL(thread)
+
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shinobi::daemon {
+
+class ServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/server_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    dir = temp_dir;
+    socket_path = dir + "/.socket";
+
+    ASSERT_EQ(0, mkdir((dir + "/a").c_str(), 0755));
+    Write("BUILDCONFIG.shi", "flags = [ \"-W\" ]\n");
+    Write("a/BUILD.shi", "group(\"a\") {\n}\n");
+
+    request.working_dir = dir;
+    request.build_config = "//BUILDCONFIG.shi";
+    request.arguments = {"//out"};
+  }
+
+  void TearDown() override {
+    FileSystem::InvalidateAll();
+    ASSERT_EQ(0, system(("rm -rf " + dir).c_str()));
+  }
+
+  void Write(const String& name, const String& contents) {
+    std::ofstream(dir + "/" + name) << contents;
+  }
+
+  Vector<String> Run(bool expected_success = true) {
+    bool success = false;
+    Vector<String> messages;
+    EXPECT_TRUE(Client::Run(socket_path, request, success, messages));
+    EXPECT_EQ(expected_success, success);
+    return messages;
+  }
+
+  Path dir, socket_path;
+  Generator::Request request;
+};
+
+TEST_F(ServerTest, ServesRuns) {
+  bool success;
+  Vector<String> messages;
+  EXPECT_FALSE(Client::Run(socket_path, request, success, messages));
+
+  Generator generator(dir, 2);
+  Watcher watcher;
+  ASSERT_TRUE(watcher.Watch(dir));
+  Server server(generator, watcher);
+  ASSERT_TRUE(server.Listen(socket_path));
+
+  // Only one daemon per socket.
+  Server other(generator, watcher);
+  EXPECT_FALSE(other.Listen(socket_path));
+
+  std::thread thread([&server] { server.Serve(); });
+
+  EXPECT_EQ(Vector<String>{"Generated 1 targets in " + dir +
+                           "/out: 1 build files evaluated, 2 files changed"},
+            Run());
+  EXPECT_EQ(Vector<String>{"Generated 1 targets in " + dir +
+                           "/out: 0 build files evaluated, 0 files changed"},
+            Run());
+
+  // The change is noticed by the watcher - not by the stat of the cache.
+  Write("a/BUILD.shi", "group(\"a\") {\n}\ngroup(\"b\") {\n}\n");
+  EXPECT_EQ(Vector<String>{"Generated 2 targets in " + dir +
+                           "/out: 1 build files evaluated, 2 files changed"},
+            Run());
+
+  Write("a/BUILD.shi", "group(\"a\") {\n");
+  EXPECT_EQ(1u, Run(false).size());
+
+  server.Stop();
+  thread.join();
+}
+
+TEST_F(ServerTest, DropsStalledClients) {
+  Generator generator(dir, 2);
+  Watcher watcher;
+  ASSERT_TRUE(watcher.Watch(dir));
+  Server server(generator, watcher, std::chrono::milliseconds(100));
+  ASSERT_TRUE(server.Listen(socket_path));
+  std::thread thread([&server] { server.Serve(); });
+
+  // Connects, but never sends the request.
+  sockaddr_un address;
+  ASSERT_TRUE(Protocol::MakeAddress(socket_path, address));
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_EQ(0, connect(fd, reinterpret_cast<sockaddr*>(&address),
+                       sizeof(address)));
+
+  EXPECT_EQ(Vector<String>{"Generated 1 targets in " + dir +
+                           "/out: 1 build files evaluated, 2 files changed"},
+            Run());
+
+  // The stalled client got no response.
+  char byte;
+  EXPECT_EQ(0, read(fd, &byte, 1));
+  close(fd);
+
+  server.Stop();
+  thread.join();
+}
+
+}  // namespace shinobi::daemon
@@ -0,0 +1,16 @@
+#include <daemon/watcher.hh>
+
+namespace shinobi::daemon {
+
+// static
+bool Watcher::IsInside(const Path& path, const Vector<Path>& dirs) {
+  for (const auto& dir : dirs) {
+    if (path.compare(0, dir.size(), dir) == 0 &&
+        (path.size() == dir.size() || path[dir.size()] == '/')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace shinobi::daemon
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <base/path.hh>
+
+#if defined(OS_MACOSX)
+#include STL(condition_variable)
+#include STL(mutex)
+#include STL(thread)
+#endif
+
+namespace shinobi::daemon {
+
+// Watches the directory trees for changes - the new directories are watched
+// as soon as they appear. The events are read without blocking, e.g. when
+// |fd()| becomes readable.
+class Watcher {
+ public:
+  // The directories with the |skip_marker| file, like the build directories
+  // with their database, aren't watched.
+  explicit Watcher(const String& skip_marker = String());
+  ~Watcher();
+
+  Watcher(const Watcher&) = delete;
+  Watcher& operator=(const Watcher&) = delete;
+
+  // Watches the |root| and all its subdirectories, except the hidden ones.
+  // Returns false, if the tree can't be watched.
+  THREAD_UNSAFE bool Watch(const Path& root);
+
+  // Appends the changed, created and removed paths. Returns false, if some
+  // events were lost - then anything may have changed.
+  THREAD_UNSAFE bool ReadEvents(Vector<Path>& changed);
+
+  // Stops watching the directory tree - e.g. a build directory, which is
+  // written by every build - and doesn't watch it, if it's created again.
+  THREAD_UNSAFE void Ignore(const Path& dir_path);
+
+  inline int fd() const { return fd_; }
+
+ private:
+  // The |path| is one of the |dirs|, or is inside one.
+  static bool IsInside(const Path& path, const Vector<Path>& dirs);
+
+  const String skip_marker_;
+
+#if defined(OS_MACOSX)
+  struct Entry {
+    i64 mtime_ns;
+    i64 size;
+    bool is_dir;
+
+    bool operator!=(const Entry& other) const {
+      return mtime_ns != other.mtime_ns || size != other.size ||
+             is_dir != other.is_dir;
+    }
+  };
+  using Snapshot = Map<Path, Entry>;
+
+  // Records the tree, except the hidden entries and the skipped directories,
+  // in |snapshot|.
+  void Scan(const Path& dir_path, const Vector<Path>& ignored,
+            Snapshot& snapshot) const;
+
+  // Rescans the trees until destroyed, and reports the differences with
+  // the previous scan through the pipe.
+  void Run();
+
+  int fd_ = -1;  // The read end of the pipe.
+  int write_fd_ = -1;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool shutdown_ = false;
+  Vector<Path> roots_, ignored_;
+  Snapshot snapshot_;
+  Vector<Path> changed_;  // Not read yet.
+
+  std::thread thread_;
+#else
+  // Appends the paths inside the tree to |created|, if it's not null.
+  bool AddTree(const Path& dir_path, Vector<Path>* created);
+
+  int fd_ = -1;
+  Map<int, Path> dirs_;  // By the watch descriptor.
+  Vector<Path> ignored_;
+#endif
+};
+
+}  // namespace shinobi::daemon
@@ -0,0 +1,166 @@
+#include <daemon/watcher.hh>
+
+#include <base/stats.hh>
+
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shinobi::daemon {
+
+namespace {
+
+const Stats::Counter events_read("watcher.events");
+const Stats::Counter dirs_watched("watcher.dirs");
+
+constexpr uint32_t kMask = IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                           IN_DELETE_SELF | IN_MODIFY | IN_MOVE_SELF |
+                           IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+}  // namespace
+
+Watcher::Watcher(const String& skip_marker)
+    : skip_marker_(skip_marker),
+      fd_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {}
+
+Watcher::~Watcher() {
+  if (fd_ != -1) {
+    close(fd_);
+  }
+}
+
+bool Watcher::Watch(const Path& root) {
+  return fd_ != -1 && AddTree(root, nullptr);
+}
+
+bool Watcher::ReadEvents(Vector<Path>& changed) {
+  alignas(inotify_event) char
+      buffer[64 * (sizeof(inotify_event) + NAME_MAX + 1)];
+  bool complete = true;
+
+  while (true) {
+    const ssize_t size = read(fd_, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    if (size <= 0) {
+      break;
+    }
+
+    for (const char* data = buffer; data < buffer + size;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(data);
+      data += sizeof(inotify_event) + event->len;
+      events_read.Add();
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        complete = false;
+        continue;
+      }
+
+      auto dir = dirs_.find(event->wd);
+      if (dir == dirs_.end()) {
+        continue;
+      }
+      if (event->mask & IN_IGNORED) {
+        dirs_.erase(dir);
+        continue;
+      }
+
+      const Path path =
+          event->len ? dir->second + "/" + event->name : dir->second;
+      if (IsInside(path, ignored_)) {
+        continue;
+      }
+      changed.push_back(path);
+
+      if ((event->mask & IN_ISDIR) &&
+          (event->mask & (IN_CREATE | IN_MOVED_TO)) && event->name[0] != '.') {
+        // The files, created before the watch was added, are reported too.
+        complete = AddTree(path, &changed) && complete;
+      }
+    }
+  }
+
+  return complete;
+}
+
+void Watcher::Ignore(const Path& dir_path) {
+  if (IsInside(dir_path, ignored_)) {
+    return;
+  }
+  ignored_.push_back(dir_path);
+
+  for (auto it = dirs_.begin(); it != dirs_.end();) {
+    if (IsInside(it->second, ignored_)) {
+      inotify_rm_watch(fd_, it->first);
+      it = dirs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool Watcher::AddTree(const Path& dir_path, Vector<Path>* created) {
+  if (IsInside(dir_path, ignored_)) {
+    return true;
+  }
+
+  // Watch before listing - so nothing slips in between.
+  const int wd = inotify_add_watch(fd_, dir_path.c_str(), kMask);
+  if (wd == -1) {
+    return false;
+  }
+  dirs_[wd] = dir_path;
+  dirs_watched.Add();
+
+  DIR* dir = opendir(dir_path.c_str());
+  if (!dir) {
+    return false;
+  }
+
+  Vector<Pair<String, bool>> entries;  // With whether it's a directory.
+  bool skipped = false;
+  while (auto* entry = readdir(dir)) {
+    const String name = entry->d_name;
+    if (!skip_marker_.empty() && name == skip_marker_) {
+      skipped = true;
+      break;
+    }
+    if (name.empty() || name[0] == '.') {
+      continue;
+    }
+
+    bool is_dir = entry->d_type == DT_DIR;
+    if (entry->d_type == DT_UNKNOWN) {
+      struct stat info;
+      is_dir = stat((dir_path + "/" + name).c_str(), &info) == 0 &&
+               S_ISDIR(info.st_mode);
+    }
+    entries.emplace_back(name, is_dir);
+  }
+  closedir(dir);
+
+  if (skipped) {
+    inotify_rm_watch(fd_, wd);
+    dirs_.erase(wd);
+    return true;
+  }
+
+  bool complete = true;
+  for (const auto& [name, is_dir] : entries) {
+    const Path path = dir_path + "/" + name;
+    if (created) {
+      created->push_back(path);
+    }
+    if (is_dir) {
+      complete = AddTree(path, created) && complete;
+    }
+  }
+
+  return complete;
+}
+
+}  // namespace shinobi::daemon
@@ -0,0 +1,188 @@
+#include <daemon/watcher.hh>
+
+#include <base/stats.hh>
+
+#include STL(chrono)
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A polling fallback: the trees are rescanned periodically by a background
+// thread, which wakes up the owner through a pipe.
+namespace shinobi::daemon {
+
+namespace {
+
+const Stats::Counter events_read("watcher.events");
+const Stats::Counter scans_done("watcher.scans");
+
+constexpr std::chrono::milliseconds kScanInterval(500);
+
+}  // namespace
+
+Watcher::Watcher(const String& skip_marker) : skip_marker_(skip_marker) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return;
+  }
+  for (int fd : fds) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  fd_ = fds[0];
+  write_fd_ = fds[1];
+}
+
+Watcher::~Watcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  condition_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  if (fd_ != -1) {
+    close(fd_);
+    close(write_fd_);
+  }
+}
+
+bool Watcher::Watch(const Path& root) {
+  struct stat info;
+  if (fd_ == -1 || stat(root.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Snapshot snapshot;
+  Scan(root, ignored_, snapshot);
+  roots_.push_back(root);
+  snapshot_.insert(snapshot.begin(), snapshot.end());
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&Watcher::Run, this);
+  }
+  return true;
+}
+
+bool Watcher::ReadEvents(Vector<Path>& changed) {
+  char buffer[64];
+  while (true) {
+    const ssize_t size = read(fd_, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    if (size <= 0) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_read.Add(changed_.size());
+  changed.insert(changed.end(), changed_.begin(), changed_.end());
+  changed_.clear();
+  return true;
+}
+
+void Watcher::Ignore(const Path& dir_path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (IsInside(dir_path, ignored_)) {
+    return;
+  }
+  ignored_.push_back(dir_path);
+
+  for (auto it = snapshot_.begin(); it != snapshot_.end();) {
+    if (IsInside(it->first, ignored_)) {
+      it = snapshot_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void Watcher::Scan(const Path& dir_path, const Vector<Path>& ignored,
+                   Snapshot& snapshot) const {
+  if (IsInside(dir_path, ignored)) {
+    return;
+  }
+
+  DIR* dir = opendir(dir_path.c_str());
+  if (!dir) {
+    return;
+  }
+
+  Vector<String> names;
+  while (auto* entry = readdir(dir)) {
+    const String name = entry->d_name;
+    if (!skip_marker_.empty() && name == skip_marker_) {
+      closedir(dir);
+      return;
+    }
+    if (!name.empty() && name[0] != '.') {
+      names.push_back(name);
+    }
+  }
+  closedir(dir);
+
+  for (const auto& name : names) {
+    const Path path = dir_path + "/" + name;
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0) {
+      continue;
+    }
+
+    const bool is_dir = S_ISDIR(info.st_mode);
+    snapshot[path] = {
+        i64(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec,
+        is_dir ? 0 : i64(info.st_size), is_dir};
+    if (is_dir) {
+      Scan(path, ignored, snapshot);
+    }
+  }
+}
+
+void Watcher::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!condition_.wait_for(lock, kScanInterval,
+                              [this] { return shutdown_; })) {
+    // Don't hold the lock while scanning - the owner may read the events.
+    const Vector<Path> roots = roots_, ignored = ignored_;
+    lock.unlock();
+    Snapshot snapshot;
+    for (const Path& root : roots) {
+      Scan(root, ignored, snapshot);
+    }
+    scans_done.Add();
+    lock.lock();
+
+    // A tree was added or ignored meanwhile - its entries aren't changed.
+    if (roots.size() != roots_.size() || ignored.size() != ignored_.size()) {
+      continue;
+    }
+
+    const size_t pending = changed_.size();
+    for (const auto& [path, entry] : snapshot) {
+      auto it = snapshot_.find(path);
+      if (it == snapshot_.end() || it->second != entry) {
+        changed_.push_back(path);
+      }
+    }
+    for (const auto& [path, entry] : snapshot_) {
+      if (!snapshot.count(path)) {
+        changed_.push_back(path);
+      }
+    }
+    snapshot_ = std::move(snapshot);
+
+    if (changed_.size() > pending) {
+      const char byte = 0;
+      (void)write(write_fd_, &byte, 1);
+    }
+  }
+}
+
+}  // namespace shinobi::daemon
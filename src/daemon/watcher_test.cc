@@ -0,0 +1,101 @@
+#include <daemon/watcher.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(algorithm)
+#include STL(fstream)
+
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace shinobi::daemon {
+
+class WatcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/watcher_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    dir = temp_dir;
+  }
+
+  void TearDown() override {
+    ASSERT_EQ(0, system(("rm -rf " + dir).c_str()));
+  }
+
+  static bool Contains(const Vector<Path>& paths, const Path& path) {
+    return std::find(paths.begin(), paths.end(), path) != paths.end();
+  }
+
+  // Collects the events until the |path| is reported - the watcher may poll.
+  static Vector<Path> WaitFor(Watcher& watcher, const Path& path) {
+    Vector<Path> changed;
+    pollfd fd = {watcher.fd(), POLLIN, 0};
+    while (!Contains(changed, path) && poll(&fd, 1, 5000) == 1) {
+      EXPECT_TRUE(watcher.ReadEvents(changed));
+    }
+    return changed;
+  }
+
+  static bool Changed(Watcher& watcher, const Path& path) {
+    return Contains(WaitFor(watcher, path), path);
+  }
+
+  Path dir;
+};
+
+TEST_F(WatcherTest, ReportsChanges) {
+  ASSERT_EQ(0, mkdir((dir + "/sub").c_str(), 0755));
+  ASSERT_EQ(0, mkdir((dir + "/.hidden").c_str(), 0755));
+
+  Watcher watcher;
+  ASSERT_TRUE(watcher.Watch(dir));
+
+  Vector<Path> changed;
+  EXPECT_TRUE(watcher.ReadEvents(changed));
+  EXPECT_TRUE(changed.empty());
+
+  std::ofstream(dir + "/.hidden/BUILD.shi") << "a = 1\n";
+  std::ofstream(dir + "/sub/BUILD.shi") << "a = 1\n";
+  changed = WaitFor(watcher, dir + "/sub/BUILD.shi");
+  EXPECT_TRUE(Contains(changed, dir + "/sub/BUILD.shi"));
+  EXPECT_FALSE(Contains(changed, dir + "/.hidden/BUILD.shi"));
+
+  // The new directories are watched too.
+  ASSERT_EQ(0, mkdir((dir + "/new").c_str(), 0755));
+  EXPECT_TRUE(Changed(watcher, dir + "/new"));
+  std::ofstream(dir + "/new/BUILD.shi") << "a = 1\n";
+  EXPECT_TRUE(Changed(watcher, dir + "/new/BUILD.shi"));
+
+  ASSERT_EQ(0, unlink((dir + "/sub/BUILD.shi").c_str()));
+  EXPECT_TRUE(Changed(watcher, dir + "/sub/BUILD.shi"));
+}
+
+TEST_F(WatcherTest, SkipsBuildDirectories) {
+  ASSERT_EQ(0, mkdir((dir + "/out").c_str(), 0755));
+  std::ofstream(dir + "/out/.db") << "";
+  ASSERT_EQ(0, mkdir((dir + "/gen").c_str(), 0755));
+
+  Watcher watcher(".db");
+  ASSERT_TRUE(watcher.Watch(dir));
+  watcher.Ignore(dir + "/gen");
+
+  std::ofstream(dir + "/out/build.ninja") << "";
+  std::ofstream(dir + "/gen/build.ninja") << "";
+  std::ofstream(dir + "/BUILD.shi") << "a = 1\n";
+  const auto changed = WaitFor(watcher, dir + "/BUILD.shi");
+  EXPECT_TRUE(Contains(changed, dir + "/BUILD.shi"));
+  EXPECT_FALSE(Contains(changed, dir + "/out/build.ninja"));
+  EXPECT_FALSE(Contains(changed, dir + "/gen/build.ninja"));
+
+  // Neither when they are created again.
+  ASSERT_EQ(0, system(("rm -rf " + dir + "/gen").c_str()));
+  ASSERT_EQ(0, mkdir((dir + "/gen").c_str(), 0755));
+  std::ofstream(dir + "/gen/build.ninja") << "";
+  std::ofstream(dir + "/BUILD.shi") << "a = 2\n";
+  EXPECT_FALSE(Contains(WaitFor(watcher, dir + "/BUILD.shi"),
+                        dir + "/gen/build.ninja"));
+}
+
+}  // namespace shinobi::daemon
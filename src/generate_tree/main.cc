@@ -0,0 +1,71 @@
+#include <base/aliases.hh>
+#include <base/logging.hh>
+#include <synthetic/tree_generator.hh>
+
+// Third-party
+#include <gflags/gflags.h>
+
+#include STL(iostream)
+
+#include <base/using_log.hh>
+
+namespace shinobi {
+
+DEFINE_string(output, String(), "Directory to write the tree to");
+DEFINE_uint64(seed, 1, "Seed of the random choices");
+DEFINE_uint32(files, 100, "Number of build files");
+DEFINE_uint32(targets_per_file, 10, "Number of targets in each build file");
+DEFINE_uint32(list_length, 10, "Number of sources and flags in the lists");
+DEFINE_uint32(nesting_depth, 2, "Depth of the nested conditions in targets");
+DEFINE_uint32(import_files, 10, "Number of the shared imported files");
+DEFINE_uint32(imports_per_file, 2, "Number of imports in each build file");
+DEFINE_string(shape, "layered",
+              "Shape of the dependency graph: chain, tree, layered or random");
+DEFINE_uint32(deps_per_target, 3,
+              "Number of deps of each target - or the fan-out of the tree");
+
+}  // namespace shinobi
+
+int main(int argc, char* argv[]) {
+  using namespace shinobi;
+  using synthetic::TreeGenerator;
+
+  gflags::SetUsageMessage(
+      "Writes a synthetic build tree - the same one for the same flags:\n\n"
+      "  generate_tree --output=<dir> [flags]\n\n"
+      "then e.g. \"shinobi --root=<dir> --stats=table //out\"");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  Log::Reset(named_levels::ERROR,
+             {std::make_pair(named_levels::INFO, named_levels::FATAL)});
+
+  if (FLAGS_output.empty()) {
+    LOG(ERROR) << "No output directory specified";
+    return 1;
+  }
+
+  TreeGenerator::Options options;
+  options.seed = FLAGS_seed;
+  options.files = FLAGS_files;
+  options.targets_per_file = FLAGS_targets_per_file;
+  options.list_length = FLAGS_list_length;
+  options.nesting_depth = FLAGS_nesting_depth;
+  options.import_files = FLAGS_import_files;
+  options.imports_per_file = FLAGS_imports_per_file;
+  options.deps_per_target = FLAGS_deps_per_target;
+  if (!TreeGenerator::ParseShape(FLAGS_shape, options.shape)) {
+    LOG(ERROR) << "Unknown graph shape: " << FLAGS_shape;
+    return 1;
+  }
+
+  const TreeGenerator generator(options);
+  try {
+    const auto files = generator.Write(FLAGS_output);
+    std::cout << "Wrote " << files << " files with " << generator.targets()
+              << " targets to " << FLAGS_output << "\n";
+  } catch (const std::exception& error) {
+    LOG(ERROR) << error.what();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,273 @@
+#include <base/aliases.hh>
+#include <base/file_system.hh>
+#include <base/logging.hh>
+#include <language/shi/loader.hh>
+
+// Third-party
+#include <gflags/gflags.h>
+
+#include STL(algorithm)
+#include STL(chrono)
+#include STL(functional)
+#include STL(iomanip)
+#include STL(iostream)
+
+#include <ftw.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <base/using_log.hh>
+
+namespace shinobi {
+
+DEFINE_string(corpus, ".",
+              "Directory with the GN files - *.gn and *.gni, recursively. "
+              "It's also the root for \"gn gen\", if it has the .gn file");
+DEFINE_string(gn, "bin/linux/gn", "Path to the GN binary to compare with");
+DEFINE_uint32(iterations, 5, "Number of measured runs of each tool");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Each run is a separate process - so its peak RSS and CPU time are its own.
+struct Measurement {
+  double wall_ms = 0, cpu_ms = 0;
+  ui64 peak_rss = 0;  // In bytes.
+  ui32 failures = 0;  // Of the files, or of the commands.
+  bool crashed = false;
+};
+
+// Keeps the best wall time and CPU time, and the largest peak RSS.
+void Merge(const Measurement& run, ui32 index, Measurement& result) {
+  if (index == 0) {
+    result = run;
+    return;
+  }
+
+  result.wall_ms = std::min(result.wall_ms, run.wall_ms);
+  result.cpu_ms = std::min(result.cpu_ms, run.cpu_ms);
+  result.peak_rss = std::max(result.peak_rss, run.peak_rss);
+  result.failures = std::max(result.failures, run.failures);
+  result.crashed = result.crashed || run.crashed;
+}
+
+// Runs the |body| in a child process, which exit code is the number of
+// failures. The usage of the child includes its own waited children.
+Measurement Measure(const std::function<ui32()>& body) {
+  Measurement result;
+  const auto begin = Clock::now();
+
+  const pid_t pid = fork();
+  if (pid == -1) {
+    result.crashed = true;
+    return result;
+  }
+  if (pid == 0) {
+    _exit(std::min<ui32>(body(), 255));
+  }
+
+  int status;
+  struct rusage usage;
+  while (wait4(pid, &status, 0, &usage) == -1) {
+    if (errno != EINTR) {
+      result.crashed = true;
+      return result;
+    }
+  }
+
+  result.wall_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+  result.cpu_ms = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+                  (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+  result.peak_rss = static_cast<ui64>(usage.ru_maxrss) * 1024;
+  result.crashed = !WIFEXITED(status);
+  result.failures = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+  return result;
+}
+
+// Returns false, if the command couldn't be run or failed. The |ok_codes|
+// are the successful exit codes.
+bool RunCommand(const Vector<String>& arguments,
+                std::initializer_list<int> ok_codes = {0}) {
+  const pid_t pid = fork();
+  if (pid == -1) {
+    return false;
+  }
+  if (pid == 0) {
+    Vector<char*> argv;
+    for (const auto& argument : arguments) {
+      argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // The output isn't measured.
+    freopen("/dev/null", "w", stdout);
+    freopen("/dev/null", "w", stderr);
+    execv(argv[0], argv.data());
+    _exit(127);
+  }
+
+  int status;
+  while (waitpid(pid, &status, 0) == -1) {
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+  return WIFEXITED(status) &&
+         std::find(ok_codes.begin(), ok_codes.end(), WEXITSTATUS(status)) !=
+             ok_codes.end();
+}
+
+void FindGnFiles(const Path& dir_path, Vector<Path>& files) {
+  Vector<FileSystem::Entry> entries;
+  if (!FileSystem::List(dir_path, entries)) {
+    return;
+  }
+
+  for (const auto& entry : entries) {
+    if (entry.name.empty() || entry.name[0] == '.') {
+      continue;
+    }
+
+    const Path path = dir_path + "/" + entry.name;
+    if (entry.is_dir) {
+      FindGnFiles(path, files);
+    } else if (entry.name.size() > 3 &&
+               (entry.name.compare(entry.name.size() - 3, 3, ".gn") == 0 ||
+                entry.name.compare(entry.name.size() - 4, 4, ".gni") == 0)) {
+      files.push_back(path);
+    }
+  }
+}
+
+void RemoveTree(const Path& path) {
+  nftw(
+      path.c_str(),
+      [](const char* file_path, const struct stat*, int, struct FTW*) {
+        return remove(file_path);
+      },
+      16, FTW_DEPTH | FTW_PHYS);
+}
+
+void Print(const char* tool, const Measurement& measurement) {
+  std::cout << std::left << std::setw(16) << tool << std::right << std::fixed
+            << std::setprecision(3) << std::setw(12) << measurement.wall_ms
+            << std::setw(12) << measurement.cpu_ms << std::setprecision(1)
+            << std::setw(12) << measurement.peak_rss / 1048576.0
+            << std::setw(10) << measurement.failures
+            << (measurement.crashed ? "  crashed" : "") << "\n";
+}
+
+}  // namespace
+
+}  // namespace shinobi
+
+int main(int argc, char* argv[]) {
+  using namespace shinobi;
+  using namespace shinobi::language::shi;
+
+  gflags::SetUsageMessage(
+      "Compares shinobi with GN over the same corpus of GN files: the "
+      "lexing and parsing of shinobi, and \"gn format\" and \"gn gen\". "
+      "Each tool runs in its own process - the best wall and CPU time, and "
+      "the largest peak RSS of the runs are reported");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  Log::Reset(named_levels::ERROR,
+             {std::make_pair(named_levels::INFO, named_levels::FATAL)});
+
+  Vector<Path> files;
+  FindGnFiles(FLAGS_corpus, files);
+  std::sort(files.begin(), files.end());
+  if (files.empty()) {
+    LOG(ERROR) << "No GN files in " << FLAGS_corpus;
+    return 1;
+  }
+
+  size_t bytes = 0;
+  for (const auto& file : files) {
+    bytes += FileSystem::Stat(file).size;
+  }
+
+  // The files, that shinobi can't parse - e.g. because of the GN features
+  // it doesn't support yet - are counted as failures.
+  const auto shinobi_parse = [&files] {
+    ui32 failures = 0;
+    for (const auto& file : files) {
+      String contents;
+      try {
+        if (!FileSystem::Read(file, contents)) {
+          ++failures;
+          continue;
+        }
+        Loader::Parse(file, contents);
+      } catch (const std::exception&) {
+        ++failures;
+      }
+    }
+    return failures;
+  };
+
+  // "gn format" takes a single file. The exit code 2 means that the file
+  // isn't formatted yet.
+  const auto gn_format = [&files] {
+    ui32 failures = 0;
+    for (const auto& file : files) {
+      if (!RunCommand({FLAGS_gn, "format", "--dry-run", file}, {0, 2})) {
+        ++failures;
+      }
+    }
+    return failures;
+  };
+
+  char out_dir[] = "/tmp/gn_benchmark-XXXXXX";
+  if (!mkdtemp(out_dir)) {
+    LOG(ERROR) << "Failed to create the output directory";
+    return 1;
+  }
+  const bool has_dot_gn = FileSystem::Stat(FLAGS_corpus + "/.gn").exists;
+  const auto gn_gen = [&out_dir] {
+    return RunCommand({FLAGS_gn, "gen", out_dir, "--root=" + FLAGS_corpus})
+               ? 0u
+               : 1u;
+  };
+
+  // The unmeasured pass warms up the page cache and reports the files, that
+  // shinobi can't parse.
+  for (const auto& file : files) {
+    String contents;
+    try {
+      if (FileSystem::Read(file, contents)) {
+        Loader::Parse(file, contents);
+      }
+    } catch (const std::exception& error) {
+      std::cerr << "Not parsed " << file << ": " << error.what() << "\n";
+    }
+  }
+
+  Measurement parse, format, gen;
+  for (ui32 i = 0; i < FLAGS_iterations; ++i) {
+    Merge(Measure(shinobi_parse), i, parse);
+    Merge(Measure(gn_format), i, format);
+    if (has_dot_gn) {
+      Merge(Measure(gn_gen), i, gen);
+    }
+  }
+  RemoveTree(out_dir);
+
+  std::cout << files.size() << " files, " << bytes << " bytes, "
+            << FLAGS_iterations << " iterations\n"
+            << std::left << std::setw(16) << "tool" << std::right
+            << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms"
+            << std::setw(12) << "peak MB" << std::setw(10) << "failures"
+            << "\n";
+  Print("shinobi parse", parse);
+  Print("gn format", format);
+  if (has_dot_gn) {
+    Print("gn gen", gen);
+  }
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <graph/builder.hh>
+
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <language/shi/exception.hh>
+
+#include STL(algorithm)
+
+namespace shinobi::graph {
+
+using namespace language::shi;
+
+namespace {
+
+const Stats::Counter targets_built("graph.targets");
+const Stats::Counter build_time("time.build_graph", Stats::MICROSECONDS);
+
+Path TrimTrailingSlash(const Path& path) {
+  if (!path.empty() && path.back() == '/') {
+    return path.substr(0, path.size() - 1);
+  }
+  return path;
+}
+
+}  // namespace
+
+Builder::Builder(const Path& source_root)
+    : source_root_(TrimTrailingSlash(source_root)) {}
+
+void Builder::Register(Evaluator& evaluator) {
+  for (auto type : {Target::EXECUTABLE, Target::GROUP, Target::SHARED_LIBRARY,
+                    Target::SOURCE_SET, Target::STATIC_LIBRARY}) {
+    evaluator.RegisterFunction(
+        Target::PrintType(type),
+        [this, type](Scope&, const CallNode* call, Vector<Value>& args,
+                     Scope* block) {
+          return AddTarget(type, call, args, block);
+        });
+  }
+}
+
+void Builder::Add(Target&& target) {
+  targets_.emplace_back(std::move(target));
+}
+
+UniquePtr<Graph> Builder::Build() {
+  Tracing::Span span("Builder::Build");
+  Stats::Timer timer(build_time);
+  Memory::Scope memory(Memory::GRAPH);
+  targets_built.Add(targets_.size());
+
+  // The order of targets shouldn't depend on the order of evaluation - to get
+  // the same output for the same inputs.
+  Vector<size_t> order(targets_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return targets_[a].label() < targets_[b].label();
+  });
+
+  Vector<Target> targets;
+  targets.reserve(targets_.size());
+  for (auto i : order) {
+    targets.emplace_back(std::move(targets_[i]));
+  }
+  targets_.clear();
+
+  return std::make_unique<Graph>(std::move(targets));
+}
+
+Value Builder::AddTarget(Target::Type type, const CallNode* call,
+                         Vector<Value>& args, Scope* block) {
+  const auto& location = call->identifier().location();
+  Memory::Scope memory(Memory::GRAPH);
+
+  if (args.size() != 1 || args[0].type() != Value::STRING || !block) {
+    throw SemanticError(location, Target::PrintType(type) +
+                                      "() expects a name and a block");
+  }
+
+  Label label;
+  if (!Label::Parse(":" + args[0].string(), DirLabel(location), label)) {
+    throw SemanticError(location, "Invalid target name: " + args[0].string());
+  }
+
+  auto variables = block->values();
+  targets_.emplace_back(type, label, location, std::move(variables));
+
+  return Value();
+}
+
+String Builder::DirLabel(const Location& location) const {
+  const auto& file_path = location.file_path();
+
+  if (file_path.compare(0, source_root_.size(), source_root_) != 0 ||
+      (file_path.size() > source_root_.size() &&
+       file_path[source_root_.size()] != '/')) {
+    throw SemanticError(location, "File is outside of the source root " +
+                                      source_root_ + ": " + file_path);
+  }
+
+  const auto dir_end = file_path.rfind('/');
+  if (dir_end <= source_root_.size()) {
+    return "//";
+  }
+
+  return "//" +
+         file_path.substr(source_root_.size() + 1,
+                          dir_end - source_root_.size() - 1);
+}
+
+}  // namespace shinobi::graph
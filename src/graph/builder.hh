@@ -0,0 +1,42 @@
+#pragma once
+
+#include <graph/graph.hh>
+#include <language/shi/evaluator.hh>
+
+namespace shinobi::graph {
+
+// Collects the targets of a single configuration from the evaluated blocks of
+// the target functions, like:
+//
+//     executable("sample") {
+//       deps = [ ":library" ]
+//     }
+//
+class Builder {
+ public:
+  // The labels are relative to the |source_root| directory.
+  explicit Builder(const Path& source_root);
+
+  THREAD_UNSAFE void Register(language::shi::Evaluator& evaluator);
+
+  // Adds the target, that wasn't evaluated in this run, e.g. restored from
+  // the incremental database.
+  THREAD_UNSAFE void Add(Target&& target);
+
+  // Throws |GraphError|, if the targets don't form a valid graph.
+  THREAD_UNSAFE UniquePtr<Graph> Build();
+
+ private:
+  language::shi::Value AddTarget(Target::Type type,
+                                 const language::shi::CallNode* call,
+                                 Vector<language::shi::Value>& args,
+                                 language::shi::Scope* block);
+
+  // Returns the label of the directory, like "//src/base".
+  String DirLabel(const Location& location) const;
+
+  const Path source_root_;
+  Vector<Target> targets_;
+};
+
+}  // namespace shinobi::graph
@@ -0,0 +1,196 @@
+#include <graph/graph.hh>
+
+#include <base/assert.hh>
+
+#include STL(algorithm)
+
+namespace shinobi::graph {
+
+namespace {
+
+String PrintLocation(const Location& location) {
+  return location.file_path() + ":" + std::to_string(location.line()) + ":" +
+         std::to_string(location.column());
+}
+
+}  // namespace
+
+GraphError::GraphError(const String& error_message,
+                       const Vector<Location>& locations)
+    : message_(error_message), locations_(locations) {
+  for (const auto& location : locations_) {
+    message_ += "\n  at " + PrintLocation(location);
+  }
+}
+
+const char* GraphError::what() const noexcept {
+  return message_.c_str();
+}
+
+Graph::Graph(Vector<Target>&& targets) : targets_(std::move(targets)) {
+  for (Index i = 0; i < targets_.size(); ++i) {
+    auto result = indices_.emplace(targets_[i].label(), i);
+    if (!result.second) {
+      throw GraphError(
+          "Duplicate target: " + targets_[i].label().ToString(),
+          {targets_[result.first->second].location(), targets_[i].location()});
+    }
+  }
+
+  auto resolve = [this](const Target& target, const Label& label) {
+    Index index;
+    if (!Find(label, index)) {
+      throw GraphError("Unknown dependency " + label.ToString() + " of " +
+                           target.label().ToString(),
+                       {target.location()});
+    }
+    return index;
+  };
+
+  // Deps, with the public ones first.
+  Vector<ui32> dependent_counts(targets_.size(), 0);
+  dep_offsets_.reserve(targets_.size() + 1);
+  public_dep_counts_.reserve(targets_.size());
+  dep_offsets_.push_back(0);
+
+  for (const auto& target : targets_) {
+    const auto begin = deps_.size();
+
+    for (const auto& label : target.public_deps()) {
+      deps_.push_back(resolve(target, label));
+    }
+    std::sort(deps_.begin() + begin, deps_.end());
+    deps_.erase(std::unique(deps_.begin() + begin, deps_.end()), deps_.end());
+    const auto public_end = deps_.size();
+
+    for (const auto& label : target.deps()) {
+      const auto index = resolve(target, label);
+      if (!std::binary_search(deps_.begin() + begin,
+                              deps_.begin() + public_end, index)) {
+        deps_.push_back(index);
+      }
+    }
+    std::sort(deps_.begin() + public_end, deps_.end());
+    deps_.erase(std::unique(deps_.begin() + public_end, deps_.end()),
+                deps_.end());
+
+    for (auto i = begin; i < deps_.size(); ++i) {
+      ++dependent_counts[deps_[i]];
+    }
+
+    public_dep_counts_.push_back(public_end - begin);
+    dep_offsets_.push_back(deps_.size());
+  }
+  deps_.shrink_to_fit();
+
+  // Reverse edges.
+  dependent_offsets_.resize(targets_.size() + 1, 0);
+  for (Index i = 0; i < targets_.size(); ++i) {
+    dependent_offsets_[i + 1] = dependent_offsets_[i] + dependent_counts[i];
+  }
+  dependents_.resize(deps_.size());
+  for (Index i = 0; i < targets_.size(); ++i) {
+    for (auto dep : deps(i)) {
+      dependents_[dependent_offsets_[dep + 1] - dependent_counts[dep]--] = i;
+    }
+  }
+
+  CheckCycles();
+}
+
+bool Graph::Find(const Label& label, Index& index) const {
+  auto it = indices_.find(label);
+  if (it == indices_.end()) {
+    return false;
+  }
+
+  index = it->second;
+  return true;
+}
+
+Graph::Edges Graph::deps(Index index) const {
+  return Edges(deps_.data() + dep_offsets_[index],
+               deps_.data() + dep_offsets_[index + 1]);
+}
+
+Graph::Edges Graph::public_deps(Index index) const {
+  return Edges(deps_.data() + dep_offsets_[index],
+               deps_.data() + dep_offsets_[index] + public_dep_counts_[index]);
+}
+
+Graph::Edges Graph::dependents(Index index) const {
+  return Edges(dependents_.data() + dependent_offsets_[index],
+               dependents_.data() + dependent_offsets_[index + 1]);
+}
+
+void Graph::Resolve(ThreadPool& pool,
+                    const std::function<void(Index)>& callback) const {
+  UniquePtr<std::atomic<ui32>[]> pending(new std::atomic<ui32>[size()]);
+  for (Index i = 0; i < size(); ++i) {
+    pending[i] = deps(i).size();
+  }
+
+  std::function<void(Index)> run = [&](Index index) {
+    callback(index);
+    for (auto dependent : dependents(index)) {
+      if (--pending[dependent] == 0) {
+        pool.Push([&run, dependent] { run(dependent); });
+      }
+    }
+  };
+
+  for (Index i = 0; i < size(); ++i) {
+    if (deps(i).size() == 0) {
+      pool.Push([&run, i] { run(i); });
+    }
+  }
+
+  pool.Wait();
+}
+
+void Graph::CheckCycles() const {
+  enum Color : ui8 { WHITE, GRAY, BLACK };
+  Vector<Color> colors(size(), WHITE);
+
+  // Iterative depth-first search: the target and the next edge to visit.
+  Vector<Pair<Index, const Index*>> stack;
+
+  for (Index root = 0; root < size(); ++root) {
+    if (colors[root] != WHITE) {
+      continue;
+    }
+
+    colors[root] = GRAY;
+    stack.emplace_back(root, deps(root).begin());
+
+    while (!stack.empty()) {
+      auto& top = stack.back();
+      if (top.second == deps(top.first).end()) {
+        colors[top.first] = BLACK;
+        stack.pop_back();
+        continue;
+      }
+
+      const auto dep = *top.second++;
+      if (colors[dep] == WHITE) {
+        colors[dep] = GRAY;
+        stack.emplace_back(dep, deps(dep).begin());
+      } else if (colors[dep] == GRAY) {
+        auto it = std::find_if(
+            stack.begin(), stack.end(),
+            [dep](const auto& item) { return item.first == dep; });
+        DCHECK(it != stack.end());
+
+        String message = "Dependency cycle: ";
+        Vector<Location> locations;
+        for (; it != stack.end(); ++it) {
+          message += target(it->first).label().ToString() + " -> ";
+          locations.push_back(target(it->first).location());
+        }
+        throw GraphError(message + target(dep).label().ToString(), locations);
+      }
+    }
+  }
+}
+
+}  // namespace shinobi::graph
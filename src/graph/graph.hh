@@ -0,0 +1,72 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <base/thread_pool.hh>
+#include <graph/target.hh>
+
+namespace shinobi::graph {
+
+class GraphError : public std::exception {
+ public:
+  GraphError(const String& error_message, const Vector<Location>& locations);
+  const char* what() const noexcept override;
+
+  inline const Vector<Location>& locations() const { return locations_; }
+
+ private:
+  String message_;
+  Vector<Location> locations_;
+};
+
+// Immutable graph of targets. The edges are stored in the compressed sparse
+// row form: the edges of the target |i| are in the range
+// [offsets[i], offsets[i + 1]) of the single array.
+class Graph {
+ public:
+  using Index = ui32;
+
+  class Edges {
+   public:
+    Edges(const Index* begin, const Index* end) : begin_(begin), end_(end) {}
+
+    inline const Index* begin() const { return begin_; }
+    inline const Index* end() const { return end_; }
+    inline size_t size() const { return end_ - begin_; }
+
+   private:
+    const Index *begin_, *end_;
+  };
+
+  // Throws |GraphError| on duplicate targets, unknown dependencies and
+  // dependency cycles.
+  explicit Graph(Vector<Target>&& targets);
+
+  inline size_t size() const { return targets_.size(); }
+  inline const Target& target(Index index) const { return targets_[index]; }
+
+  bool Find(const Label& label, Index& index) const;
+
+  // The public deps go first.
+  Edges deps(Index index) const;
+  Edges public_deps(Index index) const;
+  Edges dependents(Index index) const;
+
+  // Calls |callback| for every target in parallel - but only after it's
+  // called for all the target's deps.
+  THREAD_SAFE void Resolve(ThreadPool& pool,
+                           const std::function<void(Index)>& callback) const;
+
+ private:
+  void CheckCycles() const;
+
+  Vector<Target> targets_;
+  Map<Label, Index> indices_;
+
+  Vector<ui32> dep_offsets_, public_dep_counts_;
+  Vector<Index> deps_;
+
+  Vector<ui32> dependent_offsets_;
+  Vector<Index> dependents_;
+};
+
+}  // namespace shinobi::graph
@@ -0,0 +1,122 @@
+#include <graph/builder.hh>
+#include <language/shi/loader.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+namespace shinobi::graph {
+
+using namespace language::shi;
+
+class GraphTest : public ::testing::Test {
+ protected:
+  void Evaluate(const Path& file_path, const String& input) {
+    files.push_back(Loader::Parse(file_path, input));
+    Scope scope;
+    evaluator.Execute(files.back()->root.get(), scope);
+  }
+
+  void SetUp() override { builder.Register(evaluator); }
+
+  Builder builder{"/root"};
+  Evaluator evaluator;
+  Vector<Loader::FilePtr> files;
+};
+
+TEST_F(GraphTest, Edges) {
+  Evaluate("/root/src/BUILD.shi",
+           "executable(\"app\") {\n"
+           "  deps = [ \":lib\", \"//src/base\" ]\n"
+           "  public_deps = [ \":lib\" ]\n"
+           "}\n"
+           "static_library(\"lib\") {\n"
+           "  deps = [ \"base\" ]\n"
+           "}\n");
+  Evaluate("/root/src/base/BUILD.shi",
+           "source_set(\"base\") {\n"
+           "  sources = [ \"base.cc\" ]\n"
+           "}\n");
+
+  auto graph = builder.Build();
+  ASSERT_EQ(3u, graph->size());
+
+  Graph::Index app, lib, base;
+  ASSERT_TRUE(graph->Find(Label("//src:app"), app));
+  ASSERT_TRUE(graph->Find(Label("//src:lib"), lib));
+  ASSERT_TRUE(graph->Find(Label("//src/base:base"), base));
+
+  EXPECT_EQ((Vector<Graph::Index>{lib, base}),
+            Vector<Graph::Index>(graph->deps(app).begin(),
+                                 graph->deps(app).end()));
+  EXPECT_EQ((Vector<Graph::Index>{lib}),
+            Vector<Graph::Index>(graph->public_deps(app).begin(),
+                                 graph->public_deps(app).end()));
+  EXPECT_EQ((Vector<Graph::Index>{app, lib}),
+            Vector<Graph::Index>(graph->dependents(base).begin(),
+                                 graph->dependents(base).end()));
+  EXPECT_EQ(0u, graph->dependents(app).size());
+
+  EXPECT_EQ(Target::SOURCE_SET, graph->target(base).type());
+  EXPECT_EQ(1u, graph->target(app).location().line());
+  EXPECT_EQ(5u, graph->target(lib).location().line());
+}
+
+TEST_F(GraphTest, Errors) {
+  Evaluate("/root/BUILD.shi",
+           "group(\"a\") {\n"
+           "  deps = [ \":b\" ]\n"
+           "}\n"
+           "group(\"b\") {\n"
+           "  deps = [ \":c\" ]\n"
+           "}\n"
+           "group(\"c\") {\n"
+           "  deps = [ \":a\" ]\n"
+           "}\n");
+
+  try {
+    builder.Build();
+    FAIL() << "Cycle isn't detected";
+  } catch (const GraphError& error) {
+    ASSERT_EQ(3u, error.locations().size());
+    EXPECT_EQ(1u, error.locations()[0].line());
+    EXPECT_EQ(4u, error.locations()[1].line());
+    EXPECT_EQ(7u, error.locations()[2].line());
+  }
+
+  Builder builder2("/root");
+  builder2.Register(evaluator);
+  Evaluate("/root/BUILD.shi",
+           "group(\"a\") {\n"
+           "  deps = [ \":unknown\" ]\n"
+           "}\n");
+  EXPECT_THROW(builder2.Build(), GraphError);
+}
+
+TEST_F(GraphTest, ParallelResolve) {
+  // A wide and deep graph: every target depends on a few previous ones.
+  String input;
+  const ui32 size = 1000;
+  for (ui32 i = 0; i < size; ++i) {
+    input += "group(\"t" + std::to_string(i) + "\") {\n  deps = [";
+    for (ui32 j = 1; j <= 3 && j * j <= i; ++j) {
+      input += " \":t" + std::to_string(i - j * j) + "\",";
+    }
+    input += " ]\n}\n";
+  }
+  Evaluate("/root/BUILD.shi", input);
+  auto graph = builder.Build();
+
+  std::atomic<ui32> order(0);
+  UniquePtr<std::atomic<ui32>[]> resolved(new std::atomic<ui32>[size]);
+  ThreadPool pool(8);
+  graph->Resolve(pool, [&](Graph::Index index) {
+    for (auto dep : graph->deps(index)) {
+      EXPECT_LT(0u, resolved[dep].load());
+    }
+    resolved[index] = ++order;
+  });
+
+  EXPECT_EQ(size, order);
+}
+
+}  // namespace shinobi::graph
@@ -0,0 +1,350 @@
+#include <graph/header_checker.hh>
+
+#include <base/file_system.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+
+#include STL(algorithm)
+#include STL(cstring)
+#include STL(mutex)
+#include STL(unordered_set)
+
+namespace shinobi::graph {
+
+using language::shi::Value;
+
+namespace {
+
+const Stats::Counter files_scanned("check.files_scanned");
+const Stats::Counter cache_hits("check.cache_hits");
+const Stats::Counter includes_checked("check.includes");
+const Stats::Counter check_time("time.check_headers", Stats::MICROSECONDS);
+
+using Includes = SharedPtr<const Vector<HeaderChecker::Include>>;
+
+// The include lists of the unchanged files are reused by the later runs of
+// the resident daemon.
+struct CachedIncludes {
+  ui64 size;
+  i64 mtime;
+  Includes includes;
+};
+
+struct Cache {
+  std::mutex mutex;
+  Map<Path, CachedIncludes> files;
+};
+
+Cache& cache() {
+  static Cache cache;
+  return cache;
+}
+
+bool HasExtension(const Path& path,
+                  std::initializer_list<const char*> extensions) {
+  const auto dot = path.rfind('.');
+  if (dot == Path::npos) {
+    return false;
+  }
+
+  const char* extension = path.c_str() + dot + 1;
+  for (const char* candidate : extensions) {
+    if (std::strcmp(extension, candidate) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IsHeader(const Path& path) {
+  return HasExtension(path, {"h", "hh", "hpp", "hxx", "inc"});
+}
+
+bool IsScanned(const Path& path) {
+  return IsHeader(path) ||
+         HasExtension(path, {"c", "cc", "cpp", "cxx", "c++", "m", "mm"});
+}
+
+// Returns the source-absolute paths of the string list.
+Vector<Path> GetPaths(const Target& target, const char* name, bool& found) {
+  Vector<Path> paths;
+  auto it = target.variables().find(name);
+  found = it != target.variables().end() && it->second.type() == Value::LIST;
+  if (!found) {
+    return paths;
+  }
+
+  for (const auto& item : it->second.list()) {
+    Path path;
+    if (item.type() == Value::STRING &&
+        ResolvePath(item.string(), target.label().dir(), path)) {
+      paths.push_back(std::move(path));
+    }
+  }
+  return paths;
+}
+
+// The missing files - like the generated ones - have no includes. Returns null
+// on errors.
+Includes ReadIncludes(const Path& file_path) {
+  const auto info = FileSystem::Stat(file_path);
+  if (!info.exists) {
+    return std::make_shared<Vector<HeaderChecker::Include>>();
+  }
+
+  auto& cache = shinobi::graph::cache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.files.find(file_path);
+    if (it != cache.files.end() && it->second.size == info.size &&
+        it->second.mtime == info.mtime) {
+      cache_hits.Add();
+      return it->second.includes;
+    }
+  }
+
+  // Read, not mapped: a file, that shrinks meanwhile - e.g. saved by an
+  // editor - would raise SIGBUS past its new end.
+  String data;
+  if (!FileSystem::Read(file_path, data)) {
+    return nullptr;
+  }
+
+  auto includes = std::make_shared<Vector<HeaderChecker::Include>>();
+  HeaderChecker::ScanIncludes(data.data(), data.size(), *includes);
+  files_scanned.Add();
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.files[file_path] = {info.size, info.mtime, includes};
+  return includes;
+}
+
+}  // namespace
+
+HeaderChecker::HeaderChecker(const Graph& graph, const Path& source_root)
+    : graph_(graph), source_root_(source_root), files_(graph.size()) {
+  for (Index i = 0; i < graph_.size(); ++i) {
+    const auto& target = graph_.target(i);
+
+    bool has_public;
+    const auto sources = GetPaths(target, "sources", has_public);
+    const auto public_headers = GetPaths(target, "public", has_public);
+
+    for (const auto& header : public_headers) {
+      headers_[header].push_back({i, true});
+    }
+    for (const auto& source : sources) {
+      if (IsHeader(source)) {
+        headers_[source].push_back({i, !has_public});
+      }
+    }
+
+    for (const auto* list : {&sources, &public_headers}) {
+      for (const auto& file : *list) {
+        if (IsScanned(file)) {
+          files_[i].push_back(file);
+        }
+      }
+    }
+  }
+}
+
+Vector<HeaderChecker::Error> HeaderChecker::Check(ThreadPool& pool) const {
+  Tracing::Span span("HeaderChecker::Check");
+  Stats::Timer timer(check_time);
+
+  std::mutex mutex;
+  Vector<Error> errors;
+  for (Index i = 0; i < graph_.size(); ++i) {
+    if (files_[i].empty()) {
+      continue;
+    }
+
+    pool.Push([this, i, &mutex, &errors] {
+      Vector<Error> target_errors;
+      CheckTarget(i, target_errors);
+      if (!target_errors.empty()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::move(target_errors.begin(), target_errors.end(),
+                  std::back_inserter(errors));
+      }
+    });
+  }
+  pool.Wait();
+
+  std::sort(errors.begin(), errors.end(), [](const Error& a, const Error& b) {
+    if (a.location.file_id() != b.location.file_id()) {
+      return a.location.file_path() < b.location.file_path();
+    }
+    return a.location < b.location;
+  });
+  return errors;
+}
+
+// static
+void HeaderChecker::ScanIncludes(const char* data, size_t size,
+                                 Vector<Include>& includes) {
+  const char* const end = data + size;
+  ui32 line = 0;
+
+  for (const char* begin = data; begin < end; ++line) {
+    // |memchr()| is vectorized by the C library.
+    const char* line_end =
+        static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    if (!line_end) {
+      line_end = end;
+    }
+
+    const char* c = begin;
+    while (c < line_end && (*c == ' ' || *c == '\t' || *c == '\r')) {
+      ++c;
+    }
+
+    if (c == line_end || (line_end - c >= 2 && c[0] == '/' && c[1] == '/')) {
+      // A blank line or a comment.
+    } else if (line_end - c >= 2 && c[0] == '/' && c[1] == '*') {
+      const char* comment_end =
+          static_cast<const char*>(memmem(c + 2, end - c - 2, "*/", 2));
+      if (!comment_end) {
+        return;
+      }
+      line += std::count(c, comment_end, '\n');
+      line_end = static_cast<const char*>(
+          std::memchr(comment_end, '\n', end - comment_end));
+      if (!line_end) {
+        return;
+      }
+    } else if (*c == '#') {
+      const char* directive = c + 1;
+      while (directive < line_end && (*directive == ' ' || *directive == '\t')) {
+        ++directive;
+      }
+
+      static constexpr char kInclude[] = "include";
+      constexpr size_t kIncludeSize = sizeof(kInclude) - 1;
+      if (static_cast<size_t>(line_end - directive) > kIncludeSize &&
+          std::memcmp(directive, kInclude, kIncludeSize) == 0) {
+        const char* path = directive + kIncludeSize;
+        while (path < line_end && (*path == ' ' || *path == '\t')) {
+          ++path;
+        }
+
+        const char close = path < line_end && *path == '<' ? '>' : '"';
+        if (path < line_end && (*path == '<' || *path == '"')) {
+          const char* path_end = static_cast<const char*>(
+              std::memchr(path + 1, close, line_end - path - 1));
+          if (path_end &&
+              !memmem(path_end, line_end - path_end, "nogncheck", 9)) {
+            includes.push_back({String(path + 1, path_end),
+                                close == '>', line + 1,
+                                static_cast<ui32>(path - begin + 1)});
+          }
+        }
+      }
+    } else {
+      // The first line of code.
+      return;
+    }
+
+    begin = line_end + 1;
+  }
+}
+
+void HeaderChecker::CheckTarget(Index index, Vector<Error>& errors) const {
+  const auto& target = graph_.target(index);
+
+  // The targets, which public headers may be included: the direct deps, and
+  // everything reachable from them through the public deps.
+  std::unordered_set<Index> allowed;
+  Vector<Index> queue(graph_.deps(index).begin(), graph_.deps(index).end());
+  allowed.insert(queue.begin(), queue.end());
+  while (!queue.empty()) {
+    const auto dep = queue.back();
+    queue.pop_back();
+    for (auto public_dep : graph_.public_deps(dep)) {
+      if (allowed.insert(public_dep).second) {
+        queue.push_back(public_dep);
+      }
+    }
+  }
+
+  bool found;
+  const auto include_dirs = GetPaths(target, "include_dirs", found);
+
+  for (const auto& file : files_[index]) {
+    const Path file_path = source_root_ + "/" + file.substr(2);
+    const auto includes = ReadIncludes(file_path);
+    if (!includes) {
+      errors.push_back({Location(file_path, 1, 1, 1),
+                        "Can't read the source file of " +
+                            target.label().ToString()});
+      continue;
+    }
+
+    for (const auto& include : *includes) {
+      includes_checked.Add();
+
+      const auto header = ResolveInclude(include, file, include_dirs);
+      if (header.empty()) {
+        continue;
+      }
+
+      const auto& owners = headers_.at(header);
+      bool is_allowed = false;
+      const Owner* private_owner = nullptr;
+      for (const auto& owner : owners) {
+        if (owner.target == index ||
+            (owner.is_public && allowed.count(owner.target))) {
+          is_allowed = true;
+          break;
+        }
+        if (allowed.count(owner.target)) {
+          private_owner = &owner;
+        }
+      }
+      if (is_allowed) {
+        continue;
+      }
+
+      const Location location(file_path, include.line, include.column, 1);
+      if (private_owner) {
+        errors.push_back(
+            {location, "Include of the private header " + header + " of " +
+                           graph_.target(private_owner->target)
+                               .label()
+                               .ToString()});
+      } else {
+        errors.push_back(
+            {location,
+             "Include of " + header + " from " +
+                 graph_.target(owners.front().target).label().ToString() +
+                 ", which isn't a dependency of " +
+                 target.label().ToString()});
+      }
+    }
+  }
+}
+
+Path HeaderChecker::ResolveInclude(const Include& include, const Path& file,
+                                   const Vector<Path>& include_dirs) const {
+  Path path;
+  if (!include.is_system &&
+      ResolvePath(include.path,
+                  file.substr(0, std::max<size_t>(file.rfind('/'), 2)), path) &&
+      headers_.count(path)) {
+    return path;
+  }
+
+  for (const auto& dir : include_dirs) {
+    if (ResolvePath(include.path, dir, path) && headers_.count(path)) {
+      return path;
+    }
+  }
+
+  if (ResolvePath(include.path, "//", path) && headers_.count(path)) {
+    return path;
+  }
+  return Path();
+}
+
+}  // namespace shinobi::graph
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <base/thread_pool.hh>
+#include <graph/graph.hh>
+
+namespace shinobi::graph {
+
+// Checks that the sources of each target include only the headers they may
+// depend on: the headers of the same target, or the public headers of its
+// deps - the direct ones, or the ones reachable through the public deps. The
+// headers, that don't belong to any target, aren't checked.
+//
+// A target's headers are public, if they're listed in its "public" variable -
+// or all the headers in "sources", if there's no such variable. An include is
+// resolved relative to the including file, if it's quoted, then against the
+// target's "include_dirs", then against the source root. The includes marked
+// with "nogncheck" are skipped.
+class HeaderChecker {
+ public:
+  struct Include {
+    String path;
+    bool is_system;  // <path> vs "path".
+    ui32 line, column;
+  };
+
+  struct Error {
+    Location location;
+    String message;
+  };
+
+  HeaderChecker(const Graph& graph, const Path& source_root);
+
+  // Scans the files in parallel. The errors are ordered by location.
+  THREAD_SAFE Vector<Error> Check(ThreadPool& pool) const;
+
+  // Finds the includes before the first line of code - after it only the
+  // comments, the blank lines and the other directives may appear.
+  static void ScanIncludes(const char* data, size_t size,
+                           Vector<Include>& includes);
+
+ private:
+  using Index = Graph::Index;
+
+  struct Owner {
+    Index target;
+    bool is_public;
+  };
+
+  void CheckTarget(Index index, Vector<Error>& errors) const;
+
+  // Returns the source-absolute path of the known header - or an empty one.
+  Path ResolveInclude(const Include& include, const Path& file,
+                      const Vector<Path>& include_dirs) const;
+
+  const Graph& graph_;
+  const Path source_root_;
+  Map<Path, Vector<Owner>> headers_;  // By the source-absolute path.
+  Vector<Vector<Path>> files_;        // To scan - by target.
+};
+
+}  // namespace shinobi::graph
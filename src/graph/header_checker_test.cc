@@ -0,0 +1,175 @@
+#include <base/file_system.hh>
+#include <graph/builder.hh>
+#include <graph/header_checker.hh>
+#include <language/shi/loader.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(cstring)
+#include STL(fstream)
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace shinobi::graph {
+
+using namespace language::shi;
+
+namespace {
+
+Vector<HeaderChecker::Include> Scan(const String& input) {
+  Vector<HeaderChecker::Include> includes;
+  HeaderChecker::ScanIncludes(input.data(), input.size(), includes);
+  return includes;
+}
+
+}  // namespace
+
+class HeaderCheckerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/header_checker_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    root = temp_dir;
+    builder = std::make_unique<Builder>(root);
+    builder->Register(evaluator);
+  }
+
+  void TearDown() override {
+    FileSystem::InvalidateAll();
+    ASSERT_EQ(0, system(("rm -rf " + root).c_str()));
+  }
+
+  void Write(const Path& path, const String& contents) {
+    const auto slash = path.rfind('/');
+    if (slash != Path::npos) {
+      ASSERT_EQ(0, system(("mkdir -p " + root + "/" + path.substr(0, slash))
+                              .c_str()));
+    }
+    std::ofstream(root + "/" + path) << contents;
+  }
+
+  void Evaluate(const Path& dir, const String& input) {
+    files.push_back(Loader::Parse(root + "/" + dir + "/BUILD.shi", input));
+    Scope scope;
+    evaluator.Execute(files.back()->root.get(), scope);
+  }
+
+  Vector<String> Check() {
+    auto graph = builder->Build();
+    ThreadPool pool(2);
+    Vector<String> errors;
+    for (const auto& error : HeaderChecker(*graph, root).Check(pool)) {
+      errors.push_back(error.location.file_path().substr(root.size()) + ":" +
+                       std::to_string(error.location.line()) + ": " +
+                       error.message);
+    }
+    return errors;
+  }
+
+  Path root;
+  Evaluator evaluator;
+  UniquePtr<Builder> builder;
+  Vector<Loader::FilePtr> files;
+};
+
+TEST(HeaderCheckerScanTest, StopsAtCode) {
+  const auto includes = Scan(
+      "// Copyright\n"
+      "/* A block\n"
+      "   comment. */\n"
+      "#pragma once\n"
+      "\n"
+      "  #  include \"a/b.hh\"\n"
+      "#include <vector>\n"
+      "#if defined(X)\n"
+      "#include \"x.hh\"  // nogncheck\n"
+      "#endif\n"
+      "#import \"c.hh\"\n"
+      "namespace x {\n"
+      "#include \"late.hh\"\n");
+
+  ASSERT_EQ(2u, includes.size());
+  EXPECT_EQ("a/b.hh", includes[0].path);
+  EXPECT_FALSE(includes[0].is_system);
+  EXPECT_EQ(6u, includes[0].line);
+  EXPECT_EQ(14u, includes[0].column);
+  EXPECT_EQ("vector", includes[1].path);
+  EXPECT_TRUE(includes[1].is_system);
+  EXPECT_EQ(7u, includes[1].line);
+}
+
+TEST(HeaderCheckerScanTest, Truncated) {
+  EXPECT_TRUE(Scan("").empty());
+  EXPECT_TRUE(Scan("#include \"unterminated").empty());
+  EXPECT_TRUE(Scan("/* unterminated\n#include \"a.hh\"\n").empty());
+  EXPECT_EQ(1u, Scan("#include \"a.hh\"").size());
+}
+
+TEST_F(HeaderCheckerTest, Dependencies) {
+  Write("base/public.hh", "");
+  Write("base/private.hh", "");
+  Write("base/base.cc", "#include \"private.hh\"\n");
+  Write("util/util.hh", "#include <base/public.hh>\n");
+  Write("app/main.cc",
+        "#include <base/public.hh>\n"
+        "#include \"base/private.hh\"\n"
+        "#include \"util/util.hh\"\n"
+        "#include \"other/other.hh\"\n"
+        "#include <string>\n");
+  Write("other/other.hh", "");
+
+  Evaluate("base",
+           "source_set(\"base\") {\n"
+           "  sources = [ \"base.cc\", \"private.hh\" ]\n"
+           "  public = [ \"public.hh\" ]\n"
+           "}\n");
+  Evaluate("util",
+           "source_set(\"util\") {\n"
+           "  sources = [ \"util.hh\" ]\n"
+           "  public_deps = [ \"//base\" ]\n"
+           "}\n");
+  Evaluate("other",
+           "source_set(\"other\") {\n"
+           "  sources = [ \"other.hh\" ]\n"
+           "}\n");
+  Evaluate("app",
+           "executable(\"app\") {\n"
+           "  sources = [ \"main.cc\" ]\n"
+           "  deps = [ \"//util\" ]\n"
+           "}\n");
+
+  const Vector<String> expected = {
+      "/app/main.cc:2: Include of the private header //base/private.hh of "
+      "//base:base",
+      "/app/main.cc:4: Include of //other/other.hh from //other:other, which "
+      "isn't a dependency of //app:app",
+  };
+  EXPECT_EQ(expected, Check());
+}
+
+TEST_F(HeaderCheckerTest, IncludeDirs) {
+  Write("lib/include/lib.hh", "");
+  Write("lib/lib.cc", "#include \"lib.hh\"\n");
+  Write("app/main.cc", "#include \"lib.hh\"\n");
+
+  Evaluate("lib",
+           "source_set(\"lib\") {\n"
+           "  sources = [ \"lib.cc\", \"include/lib.hh\" ]\n"
+           "  include_dirs = [ \"include\" ]\n"
+           "}\n");
+  Evaluate("app",
+           "executable(\"app\") {\n"
+           "  sources = [ \"main.cc\" ]\n"
+           "  include_dirs = [ \"//lib/include\" ]\n"
+           "}\n");
+
+  const Vector<String> expected = {
+      "/app/main.cc:1: Include of //lib/include/lib.hh from //lib:lib, which "
+      "isn't a dependency of //app:app",
+  };
+  EXPECT_EQ(expected, Check());
+}
+
+}  // namespace shinobi::graph
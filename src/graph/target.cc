@@ -0,0 +1,90 @@
+#include <graph/target.hh>
+
+#include <base/assert.hh>
+#include <language/shi/exception.hh>
+
+namespace shinobi::graph {
+
+namespace {
+
+Vector<Label> ResolveLabels(const Target::Values& variables,
+                            const String& name, const Path& dir,
+                            const Location& location) {
+  Vector<Label> labels;
+
+  auto it = variables.find(name);
+  if (it == variables.end()) {
+    return labels;
+  }
+
+  const auto& value = it->second;
+  if (value.type() != language::shi::Value::LIST) {
+    throw language::shi::SemanticError(location,
+                                       "Expected list of labels: " + name);
+  }
+
+  labels.reserve(value.list().size());
+  for (const auto& item : value.list()) {
+    labels.emplace_back();
+    if (item.type() != language::shi::Value::STRING ||
+        !Label::Parse(item.string(), dir, labels.back())) {
+      throw language::shi::SemanticError(location,
+                                         "Expected label: " + item.ToString());
+    }
+  }
+
+  return labels;
+}
+
+}  // namespace
+
+Target::Target(Type type, const Label& label, const Location& location,
+               Values&& variables)
+    : type_(type),
+      label_(label),
+      location_(location),
+      variables_(std::move(variables)) {
+  deps_ = ResolveLabels(variables_, "deps", label_.dir(), location_);
+  public_deps_ =
+      ResolveLabels(variables_, "public_deps", label_.dir(), location_);
+}
+
+// static
+bool Target::TypeFromName(const String& name, Type& type) {
+  static const Map<String, Type> types = {
+      {"executable", EXECUTABLE},
+      {"group", GROUP},
+      {"shared_library", SHARED_LIBRARY},
+      {"source_set", SOURCE_SET},
+      {"static_library", STATIC_LIBRARY},
+  };
+
+  auto it = types.find(name);
+  if (it == types.end()) {
+    return false;
+  }
+
+  type = it->second;
+  return true;
+}
+
+// static
+String Target::PrintType(Type type) {
+  switch (type) {
+    case EXECUTABLE:
+      return "executable";
+    case GROUP:
+      return "group";
+    case SHARED_LIBRARY:
+      return "shared_library";
+    case SOURCE_SET:
+      return "source_set";
+    case STATIC_LIBRARY:
+      return "static_library";
+  }
+
+  NOTREACHED();
+  return String();
+}
+
+}  // namespace shinobi::graph
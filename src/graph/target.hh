@@ -0,0 +1,46 @@
+#pragma once
+
+#include <base/label.hh>
+#include <base/location.hh>
+#include <language/shi/scope.hh>
+
+namespace shinobi::graph {
+
+class Target {
+ public:
+  enum Type {
+    EXECUTABLE,
+    GROUP,
+    SHARED_LIBRARY,
+    SOURCE_SET,
+    STATIC_LIBRARY,
+  };
+
+  using Values = language::shi::Scope::Values;
+
+  Target(Type type, const Label& label, const Location& location,
+         Values&& variables);
+
+  // Returns false if |name| isn't a target function.
+  static bool TypeFromName(const String& name, Type& type);
+  static String PrintType(Type type);
+
+  inline Type type() const { return type_; }
+  inline const Label& label() const { return label_; }
+  inline const Location& location() const { return location_; }
+
+  // All the variables from the target's block.
+  inline const Values& variables() const { return variables_; }
+
+  inline const Vector<Label>& deps() const { return deps_; }
+  inline const Vector<Label>& public_deps() const { return public_deps_; }
+
+ private:
+  Type type_;
+  Label label_;
+  Location location_;
+  Values variables_;
+  Vector<Label> deps_, public_deps_;
+};
+
+}  // namespace shinobi::graph
@@ -0,0 +1,373 @@
+#include <incremental/database.hh>
+
+#include <base/file_system.hh>
+#include <base/hash.hh>
+#include <output/output_file.hh>
+
+#include STL(cstring)
+#include STL(fstream)
+#include STL(sstream)
+
+namespace shinobi::incremental {
+
+using graph::Target;
+using language::shi::Value;
+
+namespace {
+
+constexpr char kMagic[] = "SHINOBI-DB";
+constexpr ui32 kVersion = 1;
+
+class Writer {
+ public:
+  explicit Writer(String& output) : output_(output) {}
+
+  template <class T>
+  void Write(T value) {
+    output_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void Write(const String& str) {
+    Write<ui32>(str.size());
+    output_.append(str);
+  }
+
+  void Write(const Location& location) {
+    Write(location.file_path());
+    Write<ui64>(location.line());
+    Write<ui64>(location.column());
+    Write<ui64>(location.byte());
+  }
+
+  void Write(const Value& value) {
+    Write<ui8>(value.type());
+    switch (value.type()) {
+      case Value::NONE:
+        break;
+      case Value::BOOLEAN:
+        Write<ui8>(value.boolean());
+        break;
+      case Value::INTEGER:
+        Write<i64>(value.integer());
+        break;
+      case Value::STRING:
+        Write(value.string());
+        break;
+      case Value::LIST:
+        Write<ui32>(value.list().size());
+        for (const auto& item : value.list()) {
+          Write(item);
+        }
+        break;
+    }
+  }
+
+  void Write(const Target& target) {
+    Write<ui8>(target.type());
+    Write(target.label().ToString());
+    Write(target.location());
+    Write<ui32>(target.variables().size());
+    for (const auto& variable : target.variables()) {
+      Write(variable.first);
+      Write(variable.second);
+    }
+  }
+
+ private:
+  String& output_;
+};
+
+// Any read past the end makes the reader invalid.
+class Reader {
+ public:
+  Reader(const String& input) : input_(input) {}
+
+  inline bool valid() const { return valid_; }
+  inline bool done() const { return offset_ == input_.size(); }
+
+  template <class T>
+  T Read() {
+    T value = T();
+    if (!Check(sizeof(value))) {
+      return value;
+    }
+    std::memcpy(&value, input_.data() + offset_, sizeof(value));
+    offset_ += sizeof(value);
+    return value;
+  }
+
+  String ReadString() {
+    const auto size = Read<ui32>();
+    if (!Check(size)) {
+      return String();
+    }
+    offset_ += size;
+    return input_.substr(offset_ - size, size);
+  }
+
+  Location ReadLocation() {
+    auto path = ReadString();
+    auto line = Read<ui64>(), column = Read<ui64>(), byte = Read<ui64>();
+    if (!valid_ || !line || !column || !byte) {
+      valid_ = false;
+      return Location();
+    }
+    return Location(path, line, column, byte);
+  }
+
+  Value ReadValue() {
+    switch (Read<ui8>()) {
+      case Value::NONE:
+        return Value();
+      case Value::BOOLEAN:
+        return Value(Read<ui8>() != 0);
+      case Value::INTEGER:
+        return Value(Read<i64>());
+      case Value::STRING:
+        return Value(ReadString());
+      case Value::LIST: {
+        Value::Items items;
+        for (auto size = Read<ui32>(); valid_ && size > 0; --size) {
+          items.emplace_back(ReadValue());
+        }
+        return Value(std::move(items));
+      }
+    }
+
+    valid_ = false;
+    return Value();
+  }
+
+  bool ReadTarget(Vector<Target>& targets) {
+    const auto type = Read<ui8>();
+    const auto label_text = ReadString();
+    auto location = ReadLocation();
+
+    Target::Values variables;
+    for (auto size = Read<ui32>(); valid_ && size > 0; --size) {
+      auto name = ReadString();
+      variables.emplace(name, ReadValue());
+    }
+
+    Label label;
+    if (!valid_ || type > Target::STATIC_LIBRARY ||
+        !Label::Parse(label_text, Path(), label)) {
+      valid_ = false;
+      return false;
+    }
+
+    targets.emplace_back(static_cast<Target::Type>(type), label, location,
+                         std::move(variables));
+    return true;
+  }
+
+ private:
+  bool Check(size_t size) {
+    valid_ = valid_ && input_.size() - offset_ >= size;
+    return valid_;
+  }
+
+  const String& input_;
+  size_t offset_ = 0;
+  bool valid_ = true;
+};
+
+}  // namespace
+
+bool Database::Stamp::operator==(const Stamp& other) const {
+  return size == other.size && mtime == other.mtime && hash == other.hash;
+}
+
+bool Database::Load(const Path& db_path, const String& fingerprint) {
+  fingerprint_ = fingerprint;
+  stamps_.clear();
+  records_.clear();
+
+  std::ifstream stream(db_path, std::ios::binary);
+  if (!stream) {
+    return false;
+  }
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  const String input = contents.str();
+
+  Reader reader(input);
+  if (reader.ReadString() != kMagic || reader.Read<ui32>() != kVersion ||
+      reader.ReadString() != fingerprint) {
+    return false;
+  }
+
+  for (auto size = reader.Read<ui32>(); reader.valid() && size > 0; --size) {
+    auto path = reader.ReadString();
+    auto& stamp = stamps_[path];
+    stamp.size = reader.Read<ui64>();
+    stamp.mtime = reader.Read<i64>();
+    stamp.hash = reader.Read<ui64>();
+  }
+
+  for (auto size = reader.Read<ui32>(); reader.valid() && size > 0; --size) {
+    auto& record = records_[reader.ReadString()];
+    for (auto inputs = reader.Read<ui32>(); reader.valid() && inputs > 0;
+         --inputs) {
+      record.inputs.emplace_back(reader.ReadString());
+    }
+    for (auto targets = reader.Read<ui32>(); reader.valid() && targets > 0;
+         --targets) {
+      reader.ReadTarget(record.targets);
+    }
+  }
+
+  if (!reader.valid() || !reader.done()) {
+    stamps_.clear();
+    records_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+void Database::Save(const Path& db_path) const {
+  output::OutputFile file(db_path, 1024 * 1024);
+  Writer writer(file.contents());
+
+  writer.Write(String(kMagic));
+  writer.Write<ui32>(kVersion);
+  writer.Write(fingerprint_);
+
+  writer.Write<ui32>(stamps_.size());
+  for (const auto& stamp : stamps_) {
+    writer.Write(stamp.first);
+    writer.Write<ui64>(stamp.second.size);
+    writer.Write<i64>(stamp.second.mtime);
+    writer.Write<ui64>(stamp.second.hash);
+  }
+
+  writer.Write<ui32>(records_.size());
+  for (const auto& record : records_) {
+    writer.Write(record.first);
+    writer.Write<ui32>(record.second.inputs.size());
+    for (const auto& input : record.second.inputs) {
+      writer.Write(input);
+    }
+    writer.Write<ui32>(record.second.targets.size());
+    for (const auto& target : record.second.targets) {
+      writer.Write(target);
+    }
+  }
+
+  file.Commit();
+}
+
+bool Database::IsUpToDate(const Path& build_file) {
+  auto it = records_.find(build_file);
+  if (it == records_.end()) {
+    return false;
+  }
+
+  for (const auto& input : it->second.inputs) {
+    if (!IsInputUpToDate(input)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Database::Record(const Path& build_file,
+                      const Vector<Pair<Path, Stamp>>& inputs,
+                      const Vector<const Target*>& targets) {
+  auto& record = records_[build_file];
+  record.inputs.clear();
+  for (const auto& input : inputs) {
+    record.inputs.push_back(input.first);
+    stamps_[input.first] = input.second;
+  }
+
+  record.targets.clear();
+  for (const auto* target : targets) {
+    record.targets.push_back(*target);
+  }
+}
+
+void Database::Retain(const Vector<Path>& build_files) {
+  Map<Path, Entry> records;
+  for (const auto& build_file : build_files) {
+    auto it = records_.find(build_file);
+    if (it != records_.end()) {
+      records.emplace(build_file, std::move(it->second));
+    }
+  }
+  records_.swap(records);
+
+  Map<Path, Stamp> stamps;
+  for (const auto& record : records_) {
+    for (const auto& input : record.second.inputs) {
+      stamps.emplace(input, stamps_[input]);
+    }
+  }
+  stamps_.swap(stamps);
+}
+
+const Vector<Target>& Database::targets(const Path& build_file) const {
+  static const Vector<Target> empty;
+
+  auto it = records_.find(build_file);
+  return it != records_.end() ? it->second.targets : empty;
+}
+
+Vector<Path> Database::inputs() const {
+  Vector<Path> inputs;
+  inputs.reserve(stamps_.size());
+  for (const auto& stamp : stamps_) {
+    inputs.push_back(stamp.first);
+  }
+  return inputs;
+}
+
+// static
+bool Database::GetStamp(const Path& file_path, Stamp& stamp) {
+  const auto info = FileSystem::Stat(file_path);
+  if (!info.exists) {
+    return false;
+  }
+
+  stamp.size = info.size;
+  stamp.mtime = info.mtime;
+  return true;
+}
+
+bool Database::IsInputUpToDate(const Path& input) {
+  auto checked = checked_inputs_.find(input);
+  if (checked != checked_inputs_.end()) {
+    return checked->second;
+  }
+
+  auto& up_to_date = checked_inputs_[input];
+  auto recorded = stamps_.find(input);
+  Stamp stamp;
+  if (recorded == stamps_.end() || !GetStamp(input, stamp)) {
+    return up_to_date = false;
+  }
+
+  // The fast path: the file wasn't touched.
+  if (stamp.size == recorded->second.size &&
+      stamp.mtime == recorded->second.mtime) {
+    return up_to_date = true;
+  }
+
+  // The file was touched, but the contents may be the same. The file, that
+  // can't be read, is out of date.
+  String contents;
+  if (!FileSystem::Read(input, contents)) {
+    return up_to_date = false;
+  }
+  stamp.hash = Hash(contents);
+  up_to_date = stamp.hash == recorded->second.hash &&
+               contents.size() == recorded->second.size;
+  if (up_to_date) {
+    recorded->second = stamp;
+  }
+  return up_to_date;
+}
+
+}  // namespace shinobi::incremental
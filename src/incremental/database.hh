@@ -0,0 +1,68 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <graph/target.hh>
+
+namespace shinobi::incremental {
+
+// Persists the results of the previous run for a single build directory:
+// the targets of every build file, and the inputs they depend on - with their
+// stat info and content hashes. The build file is re-evaluated only if any of
+// its inputs changed.
+class Database {
+ public:
+  struct Stamp {
+    ui64 size = 0;
+    i64 mtime = 0;  // In nanoseconds.
+    ui64 hash = 0;
+
+    bool operator==(const Stamp& other) const;
+  };
+
+  // Returns false and stays empty, if the database is missing, corrupted or
+  // was saved with the different |fingerprint|, e.g. with the different args.
+  THREAD_UNSAFE bool Load(const Path& db_path, const String& fingerprint);
+  THREAD_UNSAFE void Save(const Path& db_path) const;
+
+  // Checks the recorded inputs of the build file. Only the inputs with the
+  // changed stat info are read to compare the content hashes.
+  THREAD_UNSAFE bool IsUpToDate(const Path& build_file);
+
+  // Replaces the record of the build file. The |inputs| include the build file
+  // itself, with the stamps of the contents, that were evaluated - see
+  // |Loader::File|. So the files, changed after they were read, are out of
+  // date for the next run.
+  THREAD_UNSAFE void Record(const Path& build_file,
+                            const Vector<Pair<Path, Stamp>>& inputs,
+                            const Vector<const graph::Target*>& targets);
+
+  // Forgets about all the build files, that aren't in the list.
+  THREAD_UNSAFE void Retain(const Vector<Path>& build_files);
+
+  const Vector<graph::Target>& targets(const Path& build_file) const;
+
+  // All the recorded inputs - to prefetch their stat info.
+  Vector<Path> inputs() const;
+
+  // Returns false if the file doesn't exist. The stat info comes from the
+  // |FileSystem| cache.
+  static bool GetStamp(const Path& file_path, Stamp& stamp);
+
+ private:
+  struct Entry {
+    Vector<Path> inputs;
+    Vector<graph::Target> targets;
+  };
+
+  // Checks each input only once per run.
+  bool IsInputUpToDate(const Path& input);
+
+  String fingerprint_;
+  Map<Path, Stamp> stamps_;  // Of all the inputs.
+  Map<Path, Entry> records_;
+
+  // Per run.
+  Map<Path, bool> checked_inputs_;
+};
+
+}  // namespace shinobi::incremental
@@ -0,0 +1,162 @@
+#include <incremental/database.hh>
+
+#include <base/file_system.hh>
+#include <base/hash.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+
+#include <stdlib.h>
+#include <sys/time.h>
+
+namespace shinobi::incremental {
+
+using language::shi::Value;
+
+class DatabaseTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/database_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    dir = temp_dir;
+    db_path = dir + "/db";
+    build_config = Write("BUILDCONFIG.shi", "a = 1\n");
+    build_file = Write("BUILD.shi", "group(\"all\") {\n}\n");
+  }
+
+  void TearDown() override {
+    ASSERT_EQ(0, system(("rm -rf " + dir).c_str()));
+  }
+
+  Path Write(const String& name, const String& contents) {
+    std::ofstream(dir + "/" + name) << contents;
+    FileSystem::Invalidate(dir + "/" + name);
+    return dir + "/" + name;
+  }
+
+  void Touch(const Path& path) {
+    struct timeval times[2] = {{1, 0}, {1, 0}};
+    ASSERT_EQ(0, utimes(path.c_str(), times));
+    FileSystem::Invalidate(path);
+  }
+
+  // Like the loader: the stat info first, then the contents.
+  static Pair<Path, Database::Stamp> Input(const Path& path) {
+    Database::Stamp stamp;
+    EXPECT_TRUE(Database::GetStamp(path, stamp));
+    String contents;
+    EXPECT_TRUE(FileSystem::Read(path, contents));
+    stamp.hash = Hash(contents);
+    return {path, stamp};
+  }
+
+  void Record(Database& database) {
+    Record(database, {Input(build_config), Input(build_file)});
+  }
+
+  void Record(Database& database,
+              const Vector<Pair<Path, Database::Stamp>>& inputs) {
+    graph::Target target(graph::Target::GROUP, Label("//:all"),
+                         Location(build_file, 1, 1, 1),
+                         {{"deps", Value(Value::Items{Value(":a")})},
+                          {"testonly", Value(true)},
+                          {"count", Value(i64(-5))}});
+    database.Record(build_file, inputs, {&target});
+  }
+
+  Path dir, db_path, build_config, build_file;
+};
+
+TEST_F(DatabaseTest, SaveAndLoad) {
+  {
+    Database database;
+    EXPECT_FALSE(database.Load(db_path, "args"));
+    EXPECT_FALSE(database.IsUpToDate(build_file));
+    Record(database);
+    database.Save(db_path);
+  }
+
+  Database database;
+  ASSERT_TRUE(database.Load(db_path, "args"));
+  EXPECT_TRUE(database.IsUpToDate(build_file));
+
+  const auto& targets = database.targets(build_file);
+  ASSERT_EQ(1u, targets.size());
+  EXPECT_EQ(Label("//:all"), targets[0].label());
+  EXPECT_EQ(graph::Target::GROUP, targets[0].type());
+  EXPECT_EQ(build_file, targets[0].location().file_path());
+  EXPECT_EQ(Vector<Label>{Label("//:a")}, targets[0].deps());
+  EXPECT_EQ(Value(true), targets[0].variables().at("testonly"));
+  EXPECT_EQ(Value(i64(-5)), targets[0].variables().at("count"));
+
+  // The different args invalidate everything.
+  Database other;
+  EXPECT_FALSE(other.Load(db_path, "other args"));
+  EXPECT_FALSE(other.IsUpToDate(build_file));
+}
+
+TEST_F(DatabaseTest, ChangedInputs) {
+  {
+    Database database;
+    Record(database);
+    database.Save(db_path);
+  }
+
+  // Touched, but not changed.
+  Touch(build_config);
+  {
+    Database database;
+    ASSERT_TRUE(database.Load(db_path, String()));
+    EXPECT_TRUE(database.IsUpToDate(build_file));
+  }
+
+  // Changed with the same size.
+  Write("BUILDCONFIG.shi", "a = 2\n");
+  Touch(build_config);
+  {
+    Database database;
+    ASSERT_TRUE(database.Load(db_path, String()));
+    EXPECT_FALSE(database.IsUpToDate(build_file));
+
+    // Removed build files are forgotten.
+    database.Retain({});
+    EXPECT_TRUE(database.targets(build_file).empty());
+  }
+}
+
+TEST_F(DatabaseTest, ChangedWhileEvaluated) {
+  // Read before the change - so the record is of the old contents.
+  const auto input = Input(build_config);
+  Write("BUILDCONFIG.shi", "a = 2\n");
+  Touch(build_config);
+  {
+    Database database;
+    Record(database, {input, Input(build_file)});
+    database.Save(db_path);
+  }
+
+  Database database;
+  ASSERT_TRUE(database.Load(db_path, String()));
+  EXPECT_FALSE(database.IsUpToDate(build_file));
+}
+
+TEST_F(DatabaseTest, Corrupted) {
+  {
+    Database database;
+    Record(database);
+    database.Save(db_path);
+  }
+
+  std::ifstream stream(db_path, std::ios::binary);
+  String contents((std::istreambuf_iterator<char>(stream)),
+                  std::istreambuf_iterator<char>());
+  Write("db", contents.substr(0, contents.size() - 3));
+
+  Database database;
+  EXPECT_FALSE(database.Load(db_path, String()));
+  EXPECT_TRUE(database.targets(build_file).empty());
+}
+
+}  // namespace shinobi::incremental
@@ -0,0 +1,286 @@
+#include <language/shi/evaluator.hh>
+
+#include <base/assert.hh>
+#include <language/shi/exception.hh>
+
+namespace shinobi::language::shi {
+
+namespace {
+
+bool ToBoolean(const Value& value, const Node* node) {
+  if (value.type() != Value::BOOLEAN) {
+    throw SemanticError(Evaluator::LocationOf(node),
+                        "Expected boolean, got " +
+                            Value::PrintType(value.type()));
+  }
+
+  return value.boolean();
+}
+
+Value Assert(Scope& /* scope */, const CallNode* call, Vector<Value>& args,
+             Scope* /* block */) {
+  if (args.empty() || args.size() > 2 || args[0].type() != Value::BOOLEAN ||
+      (args.size() == 2 && args[1].type() != Value::STRING)) {
+    throw SemanticError(call->identifier().location(),
+                        "assert() expects a boolean and an optional message");
+  }
+
+  if (!args[0].boolean()) {
+    throw SemanticError(call->identifier().location(),
+                        "Assertion failed" +
+                            (args.size() == 2 ? ": " + args[1].string()
+                                              : String()));
+  }
+
+  return Value();
+}
+
+// The arguments from command-line are set in the scope before - or in its
+// parent, for the imported files - so they override the default values.
+Value DeclareArgs(Scope& scope, const CallNode* call, Vector<Value>& args,
+                  Scope* block) {
+  if (!args.empty() || !block) {
+    throw SemanticError(call->identifier().location(),
+                        "declare_args() expects no arguments and a block");
+  }
+
+  for (const auto& value : block->values()) {
+    if (!scope.Get(value.first)) {
+      scope.Set(value.first, value.second);
+    }
+  }
+
+  return Value();
+}
+
+}  // namespace
+
+Evaluator::Evaluator() {
+  RegisterFunction("assert", Assert);
+  RegisterFunction("declare_args", DeclareArgs);
+}
+
+void Evaluator::RegisterFunction(const String& name, Function function) {
+  functions_[name] = std::move(function);
+}
+
+void Evaluator::Execute(const Node* stmt_list, Scope& scope) const {
+  for (const auto& stmt : *stmt_list->asStatementList()) {
+    switch (stmt->type()) {
+      case Node::ASSIGNMENT:
+        ExecuteAssignment(stmt->asAssignment(), scope);
+        break;
+      case Node::CALL:
+        EvaluateCall(stmt->asCall(), scope);
+        break;
+      case Node::CONDITION:
+        ExecuteCondition(stmt->asCondition(), scope);
+        break;
+      default:
+        NOTREACHED();
+    }
+  }
+}
+
+Value Evaluator::Evaluate(const Node* expr, Scope& scope) const {
+  switch (expr->type()) {
+    case Node::ARRAY_ACCESS: {
+      const auto* access = expr->asArrayAccess();
+      const auto* list = scope.Get(access->identifier().value());
+      if (!list || list->type() != Value::LIST) {
+        throw SemanticError(access->identifier().location(),
+                            "Expected list: " + access->identifier().value());
+      }
+
+      auto index = Evaluate(access->expression(), scope);
+      if (index.type() != Value::INTEGER || index.integer() < 0 ||
+          static_cast<ui64>(index.integer()) >= list->list().size()) {
+        throw SemanticError(LocationOf(access->expression()),
+                            "Invalid index: " + index.ToString());
+      }
+
+      return list->list()[index.integer()];
+    }
+
+    case Node::BINARY_OP:
+      return EvaluateBinaryOp(expr->asBinaryOp(), scope);
+
+    case Node::CALL:
+      return EvaluateCall(expr->asCall(), scope);
+
+    case Node::EXPRESSION_LIST: {
+      Value::Items items;
+      for (const auto& item : *expr->asExpressionList()) {
+        items.emplace_back(Evaluate(item.get(), scope));
+      }
+      return Value(std::move(items));
+    }
+
+    case Node::IDENTIFIER: {
+      const auto& id = expr->asIdentifier()->identifier();
+      const auto* value = scope.Get(id.value());
+      if (!value) {
+        throw SemanticError(id.location(), "Undefined identifier: " +
+                                               id.value());
+      }
+      return *value;
+    }
+
+    case Node::LITERAL:
+      return Value::FromLiteral(expr->asLiteral()->value());
+
+    case Node::NOT: {
+      const auto* inner = expr->asNot()->expression();
+      return Value(!ToBoolean(Evaluate(inner, scope), inner));
+    }
+
+    case Node::SCOPE_ACCESS:
+      // TODO: implement scope values.
+      throw SemanticError(expr->asScopeAccess()->identifier().location(),
+                          "Scope access isn't supported");
+
+    default:
+      NOTREACHED();
+  }
+
+  return Value();
+}
+
+// static
+Location Evaluator::LocationOf(const Node* node) {
+  switch (node->type()) {
+    case Node::ARRAY_ACCESS:
+      return node->asArrayAccess()->identifier().location();
+    case Node::ASSIGNMENT:
+      return LocationOf(node->asAssignment()->left_value());
+    case Node::BINARY_OP:
+      return LocationOf(node->asBinaryOp()->left_expression());
+    case Node::CALL:
+      return node->asCall()->identifier().location();
+    case Node::CONDITION:
+      return LocationOf(node->asCondition()->if_expression());
+    case Node::EXPRESSION_LIST: {
+      const auto* list = node->asExpressionList();
+      return list->begin() != list->end() ? LocationOf(list->begin()->get())
+                                          : Location();
+    }
+    case Node::IDENTIFIER:
+      return node->asIdentifier()->identifier().location();
+    case Node::LITERAL:
+      return node->asLiteral()->value().location();
+    case Node::NOT:
+      return LocationOf(node->asNot()->expression());
+    case Node::SCOPE_ACCESS:
+      return node->asScopeAccess()->identifier().location();
+    case Node::STATEMENT_LIST: {
+      const auto* list = node->asStatementList();
+      return list->begin() != list->end() ? LocationOf(list->begin()->get())
+                                          : Location();
+    }
+  }
+
+  NOTREACHED();
+  return Location();
+}
+
+void Evaluator::ExecuteAssignment(const AssignmentNode* node,
+                                  Scope& scope) const {
+  const auto& op = node->operation();
+  const auto& name = node->left_value()->asIdentifier()->identifier().value();
+  auto rvalue = Evaluate(node->right_value(), scope);
+
+  if (op.type() == Token::EQUAL) {
+    scope.Set(name, std::move(rvalue));
+    return;
+  }
+
+  DCHECK(op.type() == Token::PLUS_EQUALS || op.type() == Token::MINUS_EQUALS);
+
+  // The modification of the value from the parent scope makes a local copy -
+  // the list items are shared until then.
+  auto* lvalue = scope.GetLocal(name);
+  if (!lvalue) {
+    const auto* parent_value = scope.Get(name);
+    if (!parent_value) {
+      throw SemanticError(op.location(), "Undefined identifier: " + name);
+    }
+    scope.Set(name, *parent_value);
+    lvalue = scope.GetLocal(name);
+  }
+
+  if (!lvalue->ApplyInPlace(op.type() == Token::PLUS_EQUALS ? Token::PLUS
+                                                             : Token::MINUS,
+                            rvalue)) {
+    throw SemanticError(op.location(),
+                        "Can't apply " + op.value() + " to " +
+                            Value::PrintType(lvalue->type()) + " and " +
+                            Value::PrintType(rvalue.type()));
+  }
+}
+
+void Evaluator::ExecuteCondition(const ConditionNode* node,
+                                 Scope& scope) const {
+  const auto* if_expr = node->if_expression();
+
+  // The conditions don't introduce a new scope.
+  if (ToBoolean(Evaluate(if_expr, scope), if_expr)) {
+    Execute(node->if_block(), scope);
+  } else if (const auto* else_stmt = node->else_statement()) {
+    if (else_stmt->type() == Node::CONDITION) {
+      ExecuteCondition(else_stmt->asCondition(), scope);
+    } else {
+      Execute(else_stmt, scope);
+    }
+  }
+}
+
+Value Evaluator::EvaluateBinaryOp(const BinaryOpNode* node,
+                                  Scope& scope) const {
+  const auto& op = node->operation();
+  auto left = Evaluate(node->left_expression(), scope);
+
+  // Short-circuit evaluation.
+  if (op.type() == Token::BOOLEAN_AND &&
+      !ToBoolean(left, node->left_expression())) {
+    return Value(false);
+  }
+  if (op.type() == Token::BOOLEAN_OR &&
+      ToBoolean(left, node->left_expression())) {
+    return Value(true);
+  }
+
+  auto right = Evaluate(node->right_expression(), scope);
+
+  Value result;
+  if (!Value::Apply(op.type(), left, right, result)) {
+    throw SemanticError(op.location(),
+                        "Can't apply " + op.value() + " to " +
+                            Value::PrintType(left.type()) + " and " +
+                            Value::PrintType(right.type()));
+  }
+
+  return result;
+}
+
+Value Evaluator::EvaluateCall(const CallNode* node, Scope& scope) const {
+  const auto& id = node->identifier();
+  auto it = functions_.find(id.value());
+  if (it == functions_.end()) {
+    throw SemanticError(id.location(), "Unknown function: " + id.value());
+  }
+
+  Vector<Value> args;
+  for (const auto& arg : *node->expression_list()->asExpressionList()) {
+    args.emplace_back(Evaluate(arg.get(), scope));
+  }
+
+  if (!node->block()) {
+    return it->second(scope, node, args, nullptr);
+  }
+
+  Scope block(&scope);
+  Execute(node->block(), block);
+  return it->second(scope, node, args, &block);
+}
+
+}  // namespace shinobi::language::shi
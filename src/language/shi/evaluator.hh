@@ -0,0 +1,39 @@
+#pragma once
+
+#include <language/shi/node.hh>
+#include <language/shi/scope.hh>
+
+#include STL(functional)
+
+namespace shinobi::language::shi {
+
+// Executes the syntax tree in a given scope. The tree is never modified, so
+// the same tree may be executed concurrently by different evaluators.
+class Evaluator {
+ public:
+  // |block| is the scope, where the block of the call was executed, or
+  // nullptr if the call has no block.
+  using Function = std::function<Value(Scope& scope, const CallNode* call,
+                                       Vector<Value>& args, Scope* block)>;
+
+  Evaluator();
+
+  void RegisterFunction(const String& name, Function function);
+
+  void Execute(const Node* stmt_list, Scope& scope) const;
+  Value Evaluate(const Node* expr, Scope& scope) const;
+
+  // Returns the location of the first token of the node.
+  static Location LocationOf(const Node* node);
+
+ private:
+  void ExecuteAssignment(const AssignmentNode* node, Scope& scope) const;
+  void ExecuteCondition(const ConditionNode* node, Scope& scope) const;
+
+  Value EvaluateBinaryOp(const BinaryOpNode* node, Scope& scope) const;
+  Value EvaluateCall(const CallNode* node, Scope& scope) const;
+
+  Map<String, Function> functions_;
+};
+
+}  // namespace shinobi::language::shi
@@ -0,0 +1,132 @@
+#include <language/shi/evaluator.hh>
+#include <language/shi/exception.hh>
+#include <language/shi/loader.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+namespace shinobi::language::shi {
+
+class EvaluatorShi : public ::testing::Test {
+ protected:
+  void Execute(const String& input) {
+    file = Loader::Parse("/fake/path/file.shi", input);
+    evaluator.Execute(file->root.get(), scope);
+  }
+
+  Loader::FilePtr file;
+  Evaluator evaluator;
+  Scope scope;
+};
+
+TEST_F(EvaluatorShi, Assignments) {
+  const String input =
+      "# comment\n"
+      "a = 1 + 2\n"
+      "b = [ \"x\", \"y\" ]\n"
+      "b += [ \"z\" ]\n"
+      "b -= [ \"x\" ]\n"
+      "c = b[1]\n"
+      "d = !(a > 2) || a == 3\n";
+  Execute(input);
+
+  EXPECT_EQ(Value(i64(3)), *scope.Get("a"));
+  EXPECT_EQ(Value(Value::Items{Value("y"), Value("z")}), *scope.Get("b"));
+  EXPECT_EQ(Value("z"), *scope.Get("c"));
+  EXPECT_EQ(Value(true), *scope.Get("d"));
+}
+
+TEST_F(EvaluatorShi, ListsAreShared) {
+  const String input =
+      "a = [ \"x\", \"y\" ]\n"
+      "b = a\n"
+      "b += [ \"z\" ]\n"
+      "c = a\n"
+      "c -= [ \"x\", \"a\", \"b\", \"c\", \"d\", \"e\", \"f\", \"g\", \"h\" ]\n"
+      "d = b + a\n";
+  Execute(input);
+
+  EXPECT_EQ(Value(Value::Items{Value("x"), Value("y")}), *scope.Get("a"));
+  EXPECT_EQ(Value(Value::Items{Value("x"), Value("y"), Value("z")}),
+            *scope.Get("b"));
+  EXPECT_EQ(Value(Value::Items{Value("y")}), *scope.Get("c"));
+  EXPECT_EQ(5u, scope.Get("d")->list().size());
+}
+
+TEST_F(EvaluatorShi, LongAppendChain) {
+  constexpr ui32 kSources = 20000;
+
+  String input = "sources = []\n";
+  for (ui32 i = 0; i < kSources; ++i) {
+    input += "sources += [ \"" + std::to_string(i) + ".cc\" ]\n";
+  }
+  input += "sources -= [ \"0.cc\", \"1.cc\", \"2.cc\" ]\n";
+  Execute(input);
+
+  const auto& sources = scope.Get("sources")->list();
+  ASSERT_EQ(kSources - 3, sources.size());
+  EXPECT_EQ(Value("3.cc"), sources.front());
+  EXPECT_EQ(Value(std::to_string(kSources - 1) + ".cc"), sources.back());
+}
+
+TEST_F(EvaluatorShi, Conditions) {
+  const String input =
+      "os = \"linux\"\n"
+      "if (os == \"mac\") {\n"
+      "  a = 1\n"
+      "} else if (os == \"linux\") {\n"
+      "  a = 2\n"
+      "} else {\n"
+      "  a = 3\n"
+      "}\n";
+  Execute(input);
+
+  EXPECT_EQ(Value(i64(2)), *scope.Get("a"));
+}
+
+TEST_F(EvaluatorShi, CallWithBlock) {
+  String name;
+  Value deps;
+  evaluator.RegisterFunction(
+      "executable",
+      [&](Scope&, const CallNode*, Vector<Value>& args, Scope* block) {
+        name = args[0].string();
+        deps = *block->Get("deps");
+        return Value();
+      });
+
+  const String input =
+      "common = [ \":base\" ]\n"
+      "executable(\"sample\") {\n"
+      "  deps = common\n"
+      "  deps += [ \":other\" ]\n"
+      "}\n";
+  Execute(input);
+
+  EXPECT_EQ("sample", name);
+  EXPECT_EQ(Value(Value::Items{Value(":base"), Value(":other")}), deps);
+  EXPECT_FALSE(scope.Get("deps"));
+  EXPECT_EQ(1u, scope.Get("common")->list().size());
+}
+
+TEST_F(EvaluatorShi, DeclareArgs) {
+  scope.Set("is_debug", Value(true));
+  Execute(
+      "declare_args() {\n"
+      "  is_debug = false\n"
+      "  version = \"1.0\"\n"
+      "}\n");
+
+  EXPECT_EQ(Value(true), *scope.Get("is_debug"));
+  EXPECT_EQ(Value("1.0"), *scope.Get("version"));
+}
+
+TEST_F(EvaluatorShi, Errors) {
+  EXPECT_THROW({ Execute("a = b\n"); }, SemanticError);
+  EXPECT_THROW({ Execute("a = 1 + \"b\"\n"); }, SemanticError);
+  EXPECT_THROW({ Execute("if (1) {\n}\n"); }, SemanticError);
+  EXPECT_THROW({ Execute("unknown()\n"); }, SemanticError);
+  EXPECT_THROW({ Execute("assert(false, \"message\")\n"); }, SemanticError);
+}
+
+}  // namespace shinobi::language::shi
@@ -81,4 +81,11 @@ const char* SemanticError::what() const noexcept {
   return message_.c_str();
 }
 
+LoadError::LoadError(const Path& file_path, const String& error_message)
+    : message_("Failed to load " + file_path + ": " + error_message) {}
+
+const char* LoadError::what() const noexcept {
+  return message_.c_str();
+}
+
 }  // namespace shinobi::language::shi
@@ -59,4 +59,13 @@ class SemanticError : public std::exception {
   String message_;
 };
 
+class LoadError : public std::exception {
+ public:
+  LoadError(const Path& file_path, const String& error_message);
+  const char* what() const noexcept override;
+
+ private:
+  String message_;
+};
+
 }  // namespace shinobi::language::shi
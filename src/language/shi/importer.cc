@@ -0,0 +1,165 @@
+#include <language/shi/importer.hh>
+
+#include <base/assert.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <language/shi/exception.hh>
+
+#include STL(algorithm)
+#include STL(unordered_set)
+
+namespace shinobi::language::shi {
+
+namespace {
+
+const Stats::Counter files_imported("importer.files_evaluated");
+const Stats::Counter cache_hits("importer.cache_hits");
+
+// The imports being evaluated by the current thread - to detect the cycles,
+// that would wait for themselves.
+thread_local Vector<Pair<const Importer*, Path>> import_stack;
+
+}  // namespace
+
+Importer::Importer(Loader& loader, OptimizedTreeCache& cache,
+                   const Scope& global_scope, const Path& source_root)
+    : loader_(loader),
+      cache_(cache),
+      global_scope_(global_scope),
+      source_root_(source_root) {}
+
+void Importer::Register(Evaluator& evaluator) {
+  evaluator_ = &evaluator;
+  evaluator.RegisterFunction(
+      "import", [this](Scope& scope, const CallNode* call, Vector<Value>& args,
+                       Scope* /* block */) {
+        return ImportInto(scope, call, args);
+      });
+}
+
+Importer::ScopePtr Importer::Import(const Path& file_path,
+                                    const Location& location) {
+  const auto entry = std::make_pair(static_cast<const Importer*>(this),
+                                    file_path);
+  if (std::find(import_stack.begin(), import_stack.end(), entry) !=
+      import_stack.end()) {
+    throw SemanticError(location, "Import cycle: " + file_path);
+  }
+
+  std::promise<ScopePtr> promise;
+  std::shared_future<ScopePtr> future;
+  bool is_importing = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = scopes_.find(file_path);
+    if (it == scopes_.end()) {
+      it = scopes_.emplace(file_path, promise.get_future().share()).first;
+      is_importing = true;
+    }
+    future = it->second;
+  }
+
+  if (!is_importing) {
+    cache_hits.Add();
+    return future.get();
+  }
+  files_imported.Add();
+
+  DCHECK(evaluator_ && optimizer_);
+  import_stack.push_back(entry);
+  try {
+    auto file = loader_.Load(file_path);
+    auto tree = cache_.Get(file_path, file->root.get(), *optimizer_);
+
+    Tracing::Span span("Importer::Import", file_path);
+    auto scope = std::make_shared<Scope>(&global_scope_);
+    evaluator_->Execute(tree->root.get(), *scope);
+
+    import_stack.pop_back();
+    promise.set_value(scope);
+    return scope;
+  } catch (...) {
+    import_stack.pop_back();
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+
+Vector<Path> Importer::ImportedPaths(const Path& file_path) {
+  std::unordered_set<Path> paths;
+  Vector<Path> queue = {file_path};
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!queue.empty()) {
+    auto it = imported_paths_.find(queue.back());
+    queue.pop_back();
+    if (it == imported_paths_.end()) {
+      continue;
+    }
+    for (const auto& path : it->second) {
+      if (paths.insert(path).second) {
+        queue.push_back(path);
+      }
+    }
+  }
+
+  Vector<Path> result(paths.begin(), paths.end());
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+Value Importer::ImportInto(Scope& scope, const CallNode* call,
+                           const Vector<Value>& args) {
+  const auto& location = call->identifier().location();
+  if (args.size() != 1 || args[0].type() != Value::STRING) {
+    throw SemanticError(location, "import() expects a path");
+  }
+
+  const Path file_path = ResolvePath(args[0].string(), location);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    imported_paths_[location.file_path()].push_back(file_path);
+  }
+  auto imported = Import(file_path, location);
+
+  // Don't let the imported values silently shadow the visible ones.
+  for (const auto& value : imported->values()) {
+    const auto* existing = scope.Get(value.first);
+    if (existing && *existing != value.second) {
+      throw SemanticError(location, "Imported value collides with the "
+                                    "existing one: " +
+                                        value.first);
+    }
+  }
+
+  scope.Import(std::move(imported));
+  return Value();
+}
+
+Path Importer::ResolvePath(const String& path, const Location& location) const {
+  Path result;
+  if (path.compare(0, 2, "//") == 0) {
+    if (source_root_.empty()) {
+      throw SemanticError(location, "No source root to import " + path);
+    }
+    result = source_root_ + "/" + path.substr(2);
+  } else {
+    // The same file is imported once - whichever way it's referred.
+    const auto& importing_file = location.file_path();
+    const auto slash = importing_file.rfind('/');
+    result = path;
+    if (path.empty() || path[0] != '/') {
+      result = (slash == Path::npos ? Path()
+                                    : importing_file.substr(0, slash + 1)) +
+               path;
+    }
+  }
+
+  if (!NormalizePath(result)) {
+    throw SemanticError(location, "Invalid import path: " + path);
+  }
+  return result;
+}
+
+}  // namespace shinobi::language::shi
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <language/shi/evaluator.hh>
+#include <language/shi/loader.hh>
+#include <language/shi/optimizer.hh>
+
+#include STL(future)
+#include STL(mutex)
+
+namespace shinobi::language::shi {
+
+// Implements "import("//build/foo.shi")" for a single configuration. Each file
+// is evaluated only once - in a child of the global scope - and the concurrent
+// importers wait for the first one. The resulting scopes are frozen and shared
+// by all the importers without copying.
+class Importer {
+ public:
+  using ScopePtr = SharedPtr<const Scope>;
+
+  // The paths like "//build/foo.shi" are resolved against the |source_root|,
+  // and the relative ones - against the directory of the importing file.
+  Importer(Loader& loader, OptimizedTreeCache& cache,
+           const Scope& global_scope, const Path& source_root);
+
+  // Registers the "import()" function, that evaluates the files with the
+  // |evaluator|.
+  THREAD_UNSAFE void Register(Evaluator& evaluator);
+
+  // The optimizer should outlive the importer or the next call.
+  THREAD_UNSAFE void set_optimizer(const Optimizer* optimizer) {
+    optimizer_ = optimizer;
+  }
+
+  // Throws |SemanticError| on import cycles, and the errors of the imported
+  // file - to every importer.
+  THREAD_SAFE ScopePtr Import(const Path& file_path, const Location& location);
+
+  // Returns the paths of all the files imported by the |file_path| - including
+  // the nested imports - sorted.
+  THREAD_SAFE Vector<Path> ImportedPaths(const Path& file_path);
+
+ private:
+  Value ImportInto(Scope& scope, const CallNode* call,
+                   const Vector<Value>& args);
+  Path ResolvePath(const String& path, const Location& location) const;
+
+  Loader& loader_;
+  OptimizedTreeCache& cache_;
+  const Scope& global_scope_;
+  const Path source_root_;
+  const Evaluator* evaluator_ = nullptr;
+  const Optimizer* optimizer_ = nullptr;
+
+  std::mutex mutex_;
+  Map<Path, std::shared_future<ScopePtr>> scopes_;
+  Map<Path, Vector<Path>> imported_paths_;  // Only the direct imports.
+};
+
+}  // namespace shinobi::language::shi
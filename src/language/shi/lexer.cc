@@ -1,14 +1,38 @@
 #include <language/shi/lexer.hh>
 
 #include <base/assert.hh>
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
 #include <language/shi/exception.hh>
 
 namespace shinobi::language::shi {
 
+namespace {
+
+const Stats::Counter bytes_lexed("lexer.bytes", Stats::BYTES);
+const Stats::Counter lex_time("time.lex", Stats::MICROSECONDS);
+const Vector<Stats::Counter> token_counters = [] {
+  Vector<Stats::Counter> counters;
+  for (ui32 type = 0; type < Token::TYPE_SIZE; ++type) {
+    counters.emplace_back("lexer.tokens[" +
+                          Token::PrintType(static_cast<Token::Type>(type)) +
+                          "]");
+  }
+  return counters;
+}();
+
+}  // namespace
+
 Lexer::Lexer(const Path& file_path, const String& contents)
-    : path_(file_path), contents_(contents) {}
+    : path_(file_path),
+      file_id_(Location::Intern(file_path)),
+      contents_(contents) {}
 
 Vector<Token> Lexer::Tokenize() {
+  Tracing::Span span("Lexer::Tokenize", path_);
+  Stats::Timer timer(lex_time);
+  Memory::Scope memory(Memory::TOKENS);
   Vector<Token> tokens;
 
   bool done = false;
@@ -16,6 +40,19 @@ Vector<Token> Lexer::Tokenize() {
     tokens.emplace_back(Next(done));
   }
 
+  if (Stats::enabled()) {
+    bytes_lexed.Add(contents_.size());
+    ui64 counts[Token::TYPE_SIZE] = {};
+    for (const auto& token : tokens) {
+      ++counts[token.type()];
+    }
+    for (ui32 type = 0; type < Token::TYPE_SIZE; ++type) {
+      if (counts[type]) {
+        token_counters[type].Add(counts[type]);
+      }
+    }
+  }
+
   return tokens;
 }
 
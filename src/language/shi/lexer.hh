@@ -14,7 +14,7 @@ class Lexer {
   Token Next(bool& done);
 
   Location CurrentLocation() const {
-    return Location(path_, line_, column_, current_ + 1);
+    return Location(file_id_, line_, column_, current_ + 1);
   }
   const char& Current() const { return contents_[current_]; }
   char LookAhead() const;
@@ -37,6 +37,7 @@ class Lexer {
   Token ConsumeComment();
 
   const Path path_;
+  const Location::FileId file_id_;
   const String& contents_;
   ui64 current_ = 0, line_ = 1, column_ = 1;
 };
@@ -0,0 +1,112 @@
+#include <language/shi/loader.hh>
+
+#include <base/hash.hh>
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <language/shi/exception.hh>
+#include <language/shi/lexer.hh>
+#include <language/shi/parser.hh>
+
+namespace shinobi::language::shi {
+
+namespace {
+
+const Stats::Counter cache_hits("loader.cache_hits");
+const Stats::Counter cache_misses("loader.cache_misses");
+const Stats::Counter files_loaded("loader.files_loaded");
+const Stats::Counter bytes_read("loader.bytes_read", Stats::BYTES);
+const Stats::Counter load_time("time.load", Stats::MICROSECONDS);
+const Stats::Counter parse_time("time.parse", Stats::MICROSECONDS);
+
+}  // namespace
+
+Loader::FilePtr Loader::Load(const Path& file_path) {
+  std::promise<FilePtr> promise;
+  std::shared_future<FilePtr> future;
+  bool is_loading = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(file_path);
+    if (it == files_.end()) {
+      it = files_.emplace(file_path, promise.get_future().share()).first;
+      is_loading = true;
+    }
+    future = it->second;
+  }
+
+  if (!is_loading) {
+    cache_hits.Add();
+    return future.get();
+  }
+  cache_misses.Add();
+
+  try {
+    Tracing::Span span("Loader::Load", file_path);
+    Stats::Timer timer(load_time);
+    const auto info = FileSystem::Stat(file_path);
+    String data;
+    if (!FileSystem::Read(file_path, data)) {
+      throw LoadError(file_path, "can't read file");
+    }
+
+    files_loaded.Add();
+    bytes_read.Add(data.size());
+
+    auto file = ParseFile(file_path, data);
+    file->info = info;
+    file->hash = Hash(data);
+    promise.set_value(file);
+    return file;
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+
+void Loader::Invalidate(const Path& file_path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_.erase(file_path);
+}
+
+void Loader::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_.clear();
+}
+
+// static
+Loader::FilePtr Loader::Parse(const Path& file_path, const String& contents) {
+  return ParseFile(file_path, contents);
+}
+
+// static
+SharedPtr<Loader::File> Loader::ParseFile(const Path& file_path,
+                                          const String& contents) {
+  auto file = std::make_shared<File>();
+  file->path = file_path;
+
+  {
+    Memory::Scope memory(Memory::TOKENS);
+    Lexer lexer(file_path, contents);
+    auto tokens = lexer.Tokenize();
+
+    // The parser doesn't expect comments.
+    file->tokens.reserve(tokens.size());
+    for (auto& token : tokens) {
+      if (token.type() != Token::COMMENT) {
+        file->tokens.emplace_back(std::move(token));
+      }
+    }
+  }
+
+  Tracing::Span span("Parser::Parse", file_path);
+  Stats::Timer timer(parse_time);
+  Memory::Scope memory(Memory::AST);
+  Parser parser(file->tokens.begin(), file->tokens.end());
+  file->root = parser.Parse();
+
+  return file;
+}
+
+}  // namespace shinobi::language::shi
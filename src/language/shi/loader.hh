@@ -0,0 +1,49 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <base/file_system.hh>
+#include <language/shi/node.hh>
+
+#include STL(future)
+#include STL(mutex)
+
+namespace shinobi::language::shi {
+
+// Reads, tokenizes and parses each file only once per process. The loaded
+// files are immutable, so they may be shared between the configurations.
+class Loader {
+ public:
+  struct File {
+    Path path;
+    Vector<Token> tokens;  // Without comments.
+    NodePtr root;
+
+    // Of the parsed contents - the stat info is taken before they were read.
+    // Only for the loaded files.
+    FileSystem::Info info;
+    ui64 hash = 0;
+  };
+
+  using FilePtr = SharedPtr<const File>;
+
+  // If the file is being loaded by another thread - waits for it.
+  // Throws |LoadError| or |SyntaxError|, if the file can't be parsed.
+  THREAD_SAFE FilePtr Load(const Path& file_path);
+
+  // The next |Load()| reads the file again - e.g. if it changed on disk. The
+  // already loaded copies stay valid.
+  THREAD_SAFE void Invalidate(const Path& file_path);
+  THREAD_SAFE void Clear();
+
+  // Parses the |contents| as if they were read from the |file_path|.
+  static FilePtr Parse(const Path& file_path, const String& contents);
+
+ private:
+  static SharedPtr<File> ParseFile(const Path& file_path,
+                                   const String& contents);
+
+  std::mutex mutex_;
+  Map<Path, std::shared_future<FilePtr>> files_;
+};
+
+}  // namespace shinobi::language::shi
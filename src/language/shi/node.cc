@@ -1,72 +1,121 @@
 #include <language/shi/node.hh>
 
 #include <base/assert.hh>
+#include <base/stats.hh>
 
 namespace shinobi::language::shi {
 
+namespace {
+
+const Vector<Stats::Counter> node_counters = [] {
+  Vector<Stats::Counter> counters;
+  for (ui32 type = 0; type <= Node::STATEMENT_LIST; ++type) {
+    counters.emplace_back("parser.nodes[" +
+                          Node::PrintType(static_cast<Node::Type>(type)) + "]");
+  }
+  return counters;
+}();
+
+}  // namespace
+
+Node::Node(Type type) : type_(type) {
+  node_counters[type].Add();
+}
+
+// static
+String Node::PrintType(Type type) {
+  switch (type) {
+    case ARRAY_ACCESS:
+      return "array access";
+    case ASSIGNMENT:
+      return "assignment";
+    case BINARY_OP:
+      return "binary operation";
+    case CALL:
+      return "call";
+    case CONDITION:
+      return "condition";
+    case EXPRESSION_LIST:
+      return "expression list";
+    case IDENTIFIER:
+      return "identifier";
+    case LITERAL:
+      return "literal";
+    case NOT:
+      return "logical \"not\"";
+    case SCOPE_ACCESS:
+      return "scope access";
+    case STATEMENT_LIST:
+      return "statement list";
+  }
+
+  NOTREACHED();
+  return String();
+}
+
 const ArrayAccessNode* Node::asArrayAccess() const {
   DCHECK(dynamic_cast<const ArrayAccessNode*>(this));
-  CHECK(type() == ARRAY_ACCESS);
+  HOT_CHECK(type() == ARRAY_ACCESS);
   return static_cast<const ArrayAccessNode*>(this);
 }
 
 const AssignmentNode* Node::asAssignment() const {
   DCHECK(dynamic_cast<const AssignmentNode*>(this));
-  CHECK(type() == ASSIGNMENT);
+  HOT_CHECK(type() == ASSIGNMENT);
   return static_cast<const AssignmentNode*>(this);
 }
 
 const BinaryOpNode* Node::asBinaryOp() const {
   DCHECK(dynamic_cast<const BinaryOpNode*>(this));
-  CHECK(type() == BINARY_OP);
+  HOT_CHECK(type() == BINARY_OP);
   return static_cast<const BinaryOpNode*>(this);
 }
 
 const CallNode* Node::asCall() const {
   DCHECK(dynamic_cast<const CallNode*>(this));
-  CHECK(type() == CALL);
+  HOT_CHECK(type() == CALL);
   return static_cast<const CallNode*>(this);
 }
 
 const ConditionNode* Node::asCondition() const {
   DCHECK(dynamic_cast<const ConditionNode*>(this));
-  CHECK(type() == CONDITION);
+  HOT_CHECK(type() == CONDITION);
   return static_cast<const ConditionNode*>(this);
 }
 
 const ExpressionListNode* Node::asExpressionList() const {
   DCHECK(dynamic_cast<const ExpressionListNode*>(this));
-  CHECK(type() == EXPRESSION_LIST);
+  HOT_CHECK(type() == EXPRESSION_LIST);
   return static_cast<const ExpressionListNode*>(this);
 }
 
 const IdentifierNode* Node::asIdentifier() const {
   DCHECK(dynamic_cast<const IdentifierNode*>(this));
-  CHECK(type() == IDENTIFIER);
+  HOT_CHECK(type() == IDENTIFIER);
   return static_cast<const IdentifierNode*>(this);
 }
 
 const LiteralNode* Node::asLiteral() const {
   DCHECK(dynamic_cast<const LiteralNode*>(this));
-  CHECK(type() == LITERAL);
+  HOT_CHECK(type() == LITERAL);
   return static_cast<const LiteralNode*>(this);
 }
 
 const NotNode* Node::asNot() const {
   DCHECK(dynamic_cast<const NotNode*>(this));
-  CHECK(type() == NOT);
+  HOT_CHECK(type() == NOT);
   return static_cast<const NotNode*>(this);
 }
 
 const ScopeAccessNode* Node::asScopeAccess() const {
   DCHECK(dynamic_cast<const ScopeAccessNode*>(this));
-  CHECK(type() == SCOPE_ACCESS);
+  HOT_CHECK(type() == SCOPE_ACCESS);
   return static_cast<const ScopeAccessNode*>(this);
 }
 
 const StatementListNode* Node::asStatementList() const {
   DCHECK(dynamic_cast<const StatementListNode*>(this));
-  CHECK(type() == STATEMENT_LIST);
+  HOT_CHECK(type() == STATEMENT_LIST);
   return static_cast<const StatementListNode*>(this);
 }
 
@@ -115,4 +164,8 @@ void StatementListNode::Append(NodePtr stmt) {
   stmts_.emplace_back(std::move(stmt));
 }
 
+void StatementListNode::Splice(StatementListNode& other) {
+  stmts_.splice(stmts_.end(), other.stmts_);
+}
+
 }  // namespace shinobi::language::shi
@@ -30,14 +30,16 @@ class Node {
     LITERAL,
     NOT,
     SCOPE_ACCESS,
-    STATEMENT_LIST,
+    STATEMENT_LIST,  // the last one
   };
 
-  explicit Node(Type type) : type_(type) {}
+  explicit Node(Type type);
   virtual ~Node() {}
 
   inline Type type() const { return type_; }
 
+  static String PrintType(Type type);
+
   const ArrayAccessNode* asArrayAccess() const;
   const AssignmentNode* asAssignment() const;
   const BinaryOpNode* asBinaryOp() const;
@@ -178,6 +180,8 @@ class StatementListNode : public Node {
   StatementListNode() : Node(STATEMENT_LIST) {}
 
   void Append(NodePtr stmt);
+  // Moves all statements of |other| to the end of this list.
+  void Splice(StatementListNode& other);
 
   inline List<NodePtr>::const_iterator begin() const { return stmts_.begin(); }
   inline List<NodePtr>::const_iterator end() const { return stmts_.end(); }
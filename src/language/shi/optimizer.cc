@@ -0,0 +1,319 @@
+#include <language/shi/optimizer.hh>
+
+#include <base/assert.hh>
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+
+#include STL(algorithm)
+
+namespace shinobi::language::shi {
+
+namespace {
+
+const Stats::Counter cache_hits("optimizer.cache_hits");
+const Stats::Counter cache_misses("optimizer.cache_misses");
+const Stats::Counter optimize_time("time.optimize", Stats::MICROSECONDS);
+
+String MakeFingerprint(const Optimizer::Bindings& bindings) {
+  Vector<String> lines;
+  for (const auto& binding : bindings) {
+    lines.emplace_back(binding.first + "=" + binding.second.ToString());
+  }
+  std::sort(lines.begin(), lines.end());
+
+  String result;
+  for (const auto& line : lines) {
+    result += line + "\n";
+  }
+  return result;
+}
+
+// Removes from |bindings| all the identifiers, that are assigned in the tree.
+void RemoveAssigned(const Node* node, Optimizer::Bindings& bindings) {
+  if (!node) {
+    return;
+  }
+
+  switch (node->type()) {
+    case Node::ASSIGNMENT: {
+      const auto* lvalue = node->asAssignment()->left_value();
+      if (lvalue->type() == Node::IDENTIFIER) {
+        bindings.erase(lvalue->asIdentifier()->identifier().value());
+      }
+    } break;
+
+    case Node::CALL:
+      RemoveAssigned(node->asCall()->block(), bindings);
+      break;
+
+    case Node::CONDITION: {
+      const auto* condition = node->asCondition();
+      RemoveAssigned(condition->if_block(), bindings);
+      RemoveAssigned(condition->else_statement(), bindings);
+    } break;
+
+    case Node::STATEMENT_LIST:
+      for (const auto& stmt : *node->asStatementList()) {
+        RemoveAssigned(stmt.get(), bindings);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+bool IsConstant(const NodePtr& node, Value& value) {
+  if (node->type() != Node::LITERAL) {
+    return false;
+  }
+
+  value = Value::FromLiteral(node->asLiteral()->value());
+  return true;
+}
+
+bool IsBoolean(const NodePtr& node, bool& boolean) {
+  Value value;
+  if (!IsConstant(node, value) || value.type() != Value::BOOLEAN) {
+    return false;
+  }
+
+  boolean = value.boolean();
+  return true;
+}
+
+}  // namespace
+
+Optimizer::Optimizer(const Bindings& bindings)
+    : bindings_(bindings), fingerprint_(MakeFingerprint(bindings)) {}
+
+UniquePtr<Optimizer::Tree> Optimizer::Optimize(const Node* root) const {
+  auto tree = std::make_unique<Tree>();
+  Context context{*tree, bindings_};
+
+  RemoveAssigned(root, context.bindings);
+  tree->root = FoldStatementList(context, root);
+
+  return tree;
+}
+
+NodePtr Optimizer::Fold(Context& context, const Node* node) const {
+  if (!node) {
+    return NodePtr();
+  }
+
+  switch (node->type()) {
+    case Node::ARRAY_ACCESS: {
+      const auto* access = node->asArrayAccess();
+      return std::make_unique<ArrayAccessNode>(
+          access->identifier(), Fold(context, access->expression()));
+    }
+
+    case Node::ASSIGNMENT: {
+      const auto* assignment = node->asAssignment();
+      DCHECK(assignment->left_value()->type() == Node::IDENTIFIER);
+      return std::make_unique<AssignmentNode>(
+          assignment->operation(),
+          std::make_unique<IdentifierNode>(
+              assignment->left_value()->asIdentifier()->identifier()),
+          Fold(context, assignment->right_value()));
+    }
+
+    case Node::BINARY_OP:
+      return FoldBinaryOp(context, node->asBinaryOp());
+
+    case Node::CALL: {
+      const auto* call = node->asCall();
+      return std::make_unique<CallNode>(
+          call->identifier(), Fold(context, call->expression_list()),
+          call->block() ? FoldStatementList(context, call->block())
+                        : NodePtr());
+    }
+
+    case Node::CONDITION:
+      return FoldBranch(context, node);
+
+    case Node::EXPRESSION_LIST: {
+      auto list = std::make_unique<ExpressionListNode>();
+      for (const auto& expr : *node->asExpressionList()) {
+        list->Append(Fold(context, expr.get()));
+      }
+      return list;
+    }
+
+    case Node::IDENTIFIER: {
+      const auto& id = node->asIdentifier()->identifier();
+      auto it = context.bindings.find(id.value());
+      if (it != context.bindings.end()) {
+        return MakeLiteral(context, id.location(), it->second);
+      }
+      return std::make_unique<IdentifierNode>(id);
+    }
+
+    case Node::LITERAL:
+      return std::make_unique<LiteralNode>(node->asLiteral()->value());
+
+    case Node::NOT:
+      return FoldNot(context, node->asNot());
+
+    case Node::SCOPE_ACCESS: {
+      const auto* access = node->asScopeAccess();
+      return std::make_unique<ScopeAccessNode>(access->identifier(),
+                                               access->inner());
+    }
+
+    case Node::STATEMENT_LIST:
+      return FoldStatementList(context, node);
+  }
+
+  NOTREACHED();
+  return NodePtr();
+}
+
+NodePtr Optimizer::FoldBinaryOp(Context& context,
+                                const BinaryOpNode* node) const {
+  const auto& op = node->operation();
+  auto left = Fold(context, node->left_expression());
+  auto right = Fold(context, node->right_expression());
+
+  Value lvalue, rvalue;
+  const bool left_is_constant = IsConstant(left, lvalue);
+  const bool right_is_constant = IsConstant(right, rvalue);
+
+  // Short-circuit evaluation doesn't need the right side to be constant.
+  if (left_is_constant && lvalue.type() == Value::BOOLEAN) {
+    if ((op.type() == Token::BOOLEAN_AND && !lvalue.boolean()) ||
+        (op.type() == Token::BOOLEAN_OR && lvalue.boolean())) {
+      return MakeLiteral(context, op.location(), lvalue);
+    }
+  }
+
+  if (!left_is_constant || !right_is_constant) {
+    return std::make_unique<BinaryOpNode>(op, std::move(left),
+                                          std::move(right));
+  }
+
+  // Fold only the well-typed expressions - leave the rest for evaluation to
+  // report errors.
+  Value result;
+  if (!Value::Apply(op.type(), lvalue, rvalue, result)) {
+    return std::make_unique<BinaryOpNode>(op, std::move(left),
+                                          std::move(right));
+  }
+
+  return MakeLiteral(context, op.location(), result);
+}
+
+// Returns the folded condition, the statement list that should be inlined, or
+// nothing - if the condition is always false and there is no "else" branch.
+NodePtr Optimizer::FoldBranch(Context& context, const Node* node) const {
+  if (!node) {
+    return NodePtr();
+  }
+
+  if (node->type() == Node::STATEMENT_LIST) {
+    return FoldStatementList(context, node);
+  }
+
+  const auto* condition = node->asCondition();
+  auto if_expr = Fold(context, condition->if_expression());
+
+  bool boolean;
+  if (IsBoolean(if_expr, boolean)) {
+    return boolean ? FoldStatementList(context, condition->if_block())
+                   : FoldBranch(context, condition->else_statement());
+  }
+
+  return std::make_unique<ConditionNode>(
+      std::move(if_expr), FoldStatementList(context, condition->if_block()),
+      FoldBranch(context, condition->else_statement()));
+}
+
+NodePtr Optimizer::FoldNot(Context& context, const NotNode* node) const {
+  auto expr = Fold(context, node->expression());
+
+  bool boolean;
+  if (IsBoolean(expr, boolean)) {
+    return MakeLiteral(context, expr->asLiteral()->value().location(),
+                       Value(!boolean));
+  }
+
+  return std::make_unique<NotNode>(std::move(expr));
+}
+
+NodePtr Optimizer::FoldStatementList(Context& context, const Node* node) const {
+  auto list = std::make_unique<StatementListNode>();
+
+  for (const auto& stmt : *node->asStatementList()) {
+    auto folded_stmt = Fold(context, stmt.get());
+
+    if (!folded_stmt) {
+      // The condition is pruned completely.
+      continue;
+    }
+
+    if (folded_stmt->type() == Node::STATEMENT_LIST) {
+      // The conditions don't introduce a new scope - inline the branch.
+      list->Splice(static_cast<StatementListNode&>(*folded_stmt));
+      continue;
+    }
+
+    list->Append(std::move(folded_stmt));
+  }
+
+  return list;
+}
+
+NodePtr Optimizer::MakeLiteral(Context& context, const Location& location,
+                               const Value& value) const {
+  switch (value.type()) {
+    case Value::BOOLEAN:
+      context.tree.tokens.emplace_back(
+          location, value.boolean() ? Token::TRUE_TOKEN : Token::FALSE_TOKEN);
+      break;
+    case Value::INTEGER:
+      context.tree.tokens.emplace_back(location, Token::INTEGER,
+                                       value.ToString());
+      break;
+    case Value::STRING:
+      context.tree.tokens.emplace_back(location, Token::STRING,
+                                       value.ToString());
+      break;
+    default:
+      NOTREACHED();
+  }
+
+  return std::make_unique<LiteralNode>(context.tree.tokens.back());
+}
+
+OptimizedTreeCache::TreePtr OptimizedTreeCache::Get(
+    const Path& file_path, const Node* root, const Optimizer& optimizer) {
+  const String key = file_path + '\0' + optimizer.fingerprint();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = trees_.find(key);
+    if (it != trees_.end()) {
+      cache_hits.Add();
+      return it->second;
+    }
+  }
+  cache_misses.Add();
+
+  // Optimize outside of the lock - to not block the other files.
+  Tracing::Span span("Optimizer::Optimize", file_path);
+  Stats::Timer timer(optimize_time);
+  Memory::Scope memory(Memory::AST);
+  TreePtr tree = optimizer.Optimize(root);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return trees_.emplace(key, std::move(tree)).first->second;
+}
+
+void OptimizedTreeCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trees_.clear();
+}
+
+}  // namespace shinobi::language::shi
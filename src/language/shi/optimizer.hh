@@ -0,0 +1,72 @@
+#pragma once
+
+#include <base/attributes.hh>
+#include <language/shi/node.hh>
+#include <language/shi/value.hh>
+
+#include STL(mutex)
+
+namespace shinobi::language::shi {
+
+// Folds constant expressions and prunes unreachable branches of conditions,
+// using the set of known bindings, e.g. |is_debug = false|. The bindings that
+// are assigned anywhere inside the tree are ignored, since their value isn't
+// fixed for the whole file.
+//
+// The original tree isn't modified: the result is a new tree, that shares the
+// unchanged tokens with the original one.
+class Optimizer {
+ public:
+  using Bindings = Map<String, Value>;
+
+  struct Tree {
+    // The nodes also refer to the tokens of the original tree, so those
+    // should outlive this tree.
+    List<Token> tokens;  // Synthesized while folding.
+    NodePtr root;
+  };
+
+  explicit Optimizer(const Bindings& bindings);
+
+  THREAD_SAFE UniquePtr<Tree> Optimize(const Node* root) const;
+
+  // Uniquely identifies the bindings - to cache trees per configuration.
+  inline const String& fingerprint() const { return fingerprint_; }
+
+ private:
+  // The state of a single |Optimize()| call.
+  struct Context {
+    Tree& tree;
+    Bindings bindings;
+  };
+
+  NodePtr Fold(Context& context, const Node* node) const;
+  NodePtr FoldBinaryOp(Context& context, const BinaryOpNode* node) const;
+  NodePtr FoldBranch(Context& context, const Node* node) const;
+  NodePtr FoldNot(Context& context, const NotNode* node) const;
+  NodePtr FoldStatementList(Context& context, const Node* node) const;
+
+  NodePtr MakeLiteral(Context& context, const Location& location,
+                      const Value& value) const;
+
+  const Bindings bindings_;
+  const String fingerprint_;
+};
+
+// Keeps the optimized trees per file and per configuration.
+class OptimizedTreeCache {
+ public:
+  using TreePtr = SharedPtr<const Optimizer::Tree>;
+
+  // Optimizes the tree only once for the same |file_path| and bindings.
+  THREAD_SAFE TreePtr Get(const Path& file_path, const Node* root,
+                          const Optimizer& optimizer);
+
+  THREAD_SAFE void Clear();
+
+ private:
+  std::mutex mutex_;
+  Map<String, TreePtr> trees_;
+};
+
+}  // namespace shinobi::language::shi
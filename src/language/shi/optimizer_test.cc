@@ -0,0 +1,155 @@
+#include <language/shi/lexer.hh>
+#include <language/shi/optimizer.hh>
+#include <language/shi/parser.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+namespace shinobi::language::shi {
+
+class OptimizerShi : public ::testing::Test {
+ protected:
+  void Optimize(const String& input, const Optimizer::Bindings& bindings) {
+    Lexer lexer("/fake/path/file.shi", input);
+    tokens = lexer.Tokenize();
+    Parser parser(tokens.begin(), tokens.end());
+    top_node = parser.Parse();
+    tree = Optimizer(bindings).Optimize(top_node.get());
+  }
+
+  Vector<Token> tokens;
+  NodePtr top_node;
+  UniquePtr<Optimizer::Tree> tree;
+};
+
+TEST_F(OptimizerShi, PruneBranches) {
+  const String input =
+      "if (os == \"linux\") {\n"
+      "  a = 1\n"
+      "} else if (os == \"mac\") {\n"
+      "  b = 2\n"
+      "} else {\n"
+      "  c = 3\n"
+      "}\n"
+      "if (!is_debug && other) {\n"
+      "  d = 4\n"
+      "}\n";
+
+  Optimize(input, {{"os", Value("mac")}, {"is_debug", Value(true)}});
+
+  ASSERT_EQ(Node::STATEMENT_LIST, tree->root->type());
+  auto stmt_it = tree->root->asStatementList()->begin(),
+       stmt_end = tree->root->asStatementList()->end();
+
+  // b = 2
+  ASSERT_NE(stmt_end, stmt_it);
+  ASSERT_EQ(Node::ASSIGNMENT, (*stmt_it)->type());
+  EXPECT_EQ("b", (*stmt_it)
+                     ->asAssignment()
+                     ->left_value()
+                     ->asIdentifier()
+                     ->identifier()
+                     .value());
+
+  EXPECT_EQ(stmt_end, ++stmt_it);
+}
+
+TEST_F(OptimizerShi, KeepUnknownConditions) {
+  const String input =
+      "if (is_debug && other) {\n"
+      "  a = 1\n"
+      "} else if (os == \"win\") {\n"
+      "  b = 2\n"
+      "}\n";
+
+  Optimize(input, {{"os", Value("linux")}, {"is_debug", Value(true)}});
+
+  auto stmt_it = tree->root->asStatementList()->begin(),
+       stmt_end = tree->root->asStatementList()->end();
+
+  ASSERT_NE(stmt_end, stmt_it);
+  ASSERT_EQ(Node::CONDITION, (*stmt_it)->type());
+  {
+    auto* condition = (*stmt_it)->asCondition();
+
+    // The "else" branch is unreachable.
+    EXPECT_FALSE(condition->else_statement());
+
+    // true && other
+    ASSERT_EQ(Node::BINARY_OP, condition->if_expression()->type());
+    auto* expr = condition->if_expression()->asBinaryOp();
+    ASSERT_EQ(Node::LITERAL, expr->left_expression()->type());
+    EXPECT_EQ(Token::TRUE_TOKEN,
+              expr->left_expression()->asLiteral()->value().type());
+  }
+
+  EXPECT_EQ(stmt_end, ++stmt_it);
+}
+
+TEST_F(OptimizerShi, FoldExpressions) {
+  const String input =
+      "a = 1 + 2 - 4\n"
+      "b = \"lib\" + name\n"
+      "c = count >= 10 || false\n";
+
+  Optimize(input, {{"name", Value("shi")}, {"count", Value(i64(3))}});
+
+  auto stmt_it = tree->root->asStatementList()->begin();
+  auto CheckLiteral = [](const Node* node, Token::Type type,
+                         const String& value) {
+    ASSERT_EQ(Node::LITERAL, node->type());
+    EXPECT_EQ(type, node->asLiteral()->value().type());
+    EXPECT_EQ(value, node->asLiteral()->value().value());
+  };
+
+  CheckLiteral((*stmt_it)->asAssignment()->right_value(), Token::INTEGER,
+               "-1");
+  ++stmt_it;
+  CheckLiteral((*stmt_it)->asAssignment()->right_value(), Token::STRING,
+               "\"libshi\"");
+  ++stmt_it;
+  CheckLiteral((*stmt_it)->asAssignment()->right_value(), Token::FALSE_TOKEN,
+               "false");
+}
+
+TEST_F(OptimizerShi, IgnoreAssignedBindings) {
+  const String input =
+      "is_debug = false\n"
+      "if (is_debug) {\n"
+      "  a = 1\n"
+      "}\n";
+
+  Optimize(input, {{"is_debug", Value(true)}});
+
+  auto stmt_it = tree->root->asStatementList()->begin();
+  ASSERT_EQ(Node::ASSIGNMENT, (*stmt_it)->type());
+  ASSERT_EQ(Node::CONDITION, (*++stmt_it)->type());
+  EXPECT_EQ(Node::IDENTIFIER,
+            (*stmt_it)->asCondition()->if_expression()->type());
+}
+
+TEST_F(OptimizerShi, CachePerConfiguration) {
+  const String input = "if (is_debug) {\n  a = 1\n}\n";
+  Lexer lexer("/fake/path/file.shi", input);
+  tokens = lexer.Tokenize();
+  top_node = Parser(tokens.begin(), tokens.end()).Parse();
+
+  OptimizedTreeCache cache;
+  Optimizer debug({{"is_debug", Value(true)}});
+  Optimizer debug_too({{"is_debug", Value(true)}});
+  Optimizer release({{"is_debug", Value(false)}});
+
+  auto debug_tree = cache.Get("/fake/path/file.shi", top_node.get(), debug);
+  auto release_tree =
+      cache.Get("/fake/path/file.shi", top_node.get(), release);
+
+  EXPECT_EQ(debug_tree,
+            cache.Get("/fake/path/file.shi", top_node.get(), debug_too));
+  EXPECT_NE(debug_tree, release_tree);
+  EXPECT_NE(debug_tree->root->asStatementList()->begin(),
+            debug_tree->root->asStatementList()->end());
+  EXPECT_EQ(release_tree->root->asStatementList()->begin(),
+            release_tree->root->asStatementList()->end());
+}
+
+}  // namespace shinobi::language::shi
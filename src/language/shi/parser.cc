@@ -153,7 +153,7 @@ NodePtr Parser::ParseExpression(ui8 precedence) {
     const auto& not_token = Consume({Token::BANG});
     const auto& not_precedence = not_token.precedence();
     DCHECK(precedence <= not_precedence);
-    return std::make_unique<NotNode>(ParseExpression(not_precedence));
+    left = std::make_unique<NotNode>(ParseExpression(not_precedence));
   } else if (Next(Token::Literals())) {
     left = ParseLiteral();
   } else {
@@ -0,0 +1,47 @@
+#include <language/shi/scope.hh>
+
+#include STL(algorithm)
+
+namespace shinobi::language::shi {
+
+const Value* Scope::Get(const String& name) const {
+  for (const auto* scope = this; scope; scope = scope->parent_) {
+    if (const auto* value = scope->GetOwnOrImported(name)) {
+      return value;
+    }
+  }
+
+  return nullptr;
+}
+
+Value* Scope::GetLocal(const String& name) {
+  auto it = values_.find(name);
+  return it != values_.end() ? &it->second : nullptr;
+}
+
+void Scope::Set(const String& name, Value value) {
+  values_[name] = std::move(value);
+}
+
+void Scope::Import(SharedPtr<const Scope> scope) {
+  if (std::find(imports_.begin(), imports_.end(), scope) == imports_.end()) {
+    imports_.emplace_back(std::move(scope));
+  }
+}
+
+const Value* Scope::GetOwnOrImported(const String& name) const {
+  auto it = values_.find(name);
+  if (it != values_.end()) {
+    return &it->second;
+  }
+
+  for (const auto& scope : imports_) {
+    if (const auto* value = scope->GetOwnOrImported(name)) {
+      return value;
+    }
+  }
+
+  return nullptr;
+}
+
+}  // namespace shinobi::language::shi
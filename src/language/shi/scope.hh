@@ -0,0 +1,45 @@
+#pragma once
+
+#include <language/shi/value.hh>
+
+namespace shinobi::language::shi {
+
+// The scope is never shared between the configurations, so it doesn't need
+// any synchronization - only the parent scopes may be read concurrently.
+class Scope {
+ public:
+  using Values = Map<String, Value>;
+
+  explicit Scope(const Scope* parent = nullptr) : parent_(parent) {}
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+  // Looks up the value through the imported and all the parent scopes.
+  const Value* Get(const String& name) const;
+  // Looks up the value only in this scope.
+  Value* GetLocal(const String& name);
+
+  void Set(const String& name, Value value);
+
+  // Makes the values of the frozen |scope| visible here without copying them.
+  // They are looked up after the own values, but before the parent's ones. The
+  // modification of an imported value makes a local copy.
+  void Import(SharedPtr<const Scope> scope);
+
+  inline const Scope* parent() const { return parent_; }
+  inline const Values& values() const { return values_; }
+  inline const Vector<SharedPtr<const Scope>>& imports() const {
+    return imports_;
+  }
+
+ private:
+  // Doesn't look into the parent scopes.
+  const Value* GetOwnOrImported(const String& name) const;
+
+  const Scope* parent_;
+  Values values_;
+  Vector<SharedPtr<const Scope>> imports_;
+};
+
+}  // namespace shinobi::language::shi
@@ -0,0 +1,124 @@
+#include <language/shi/session.hh>
+
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <language/shi/importer.hh>
+
+#include STL(thread)
+
+namespace shinobi::language::shi {
+
+namespace {
+
+const Stats::Counter files_evaluated("session.files_evaluated");
+const Stats::Counter files_skipped("session.files_skipped");
+const Stats::Counter evaluate_time("time.evaluate", Stats::MICROSECONDS);
+
+}  // namespace
+
+Session::Session(Loader& loader, Setup setup, Filter filter,
+                 const Path& source_root)
+    : loader_(loader),
+      setup_(std::move(setup)),
+      filter_(std::move(filter)),
+      source_root_(source_root) {}
+
+Vector<UniquePtr<Session::Result>> Session::Evaluate(
+    const Path& build_config, const Vector<Path>& build_files,
+    const Vector<Configuration>& configurations) {
+  Vector<UniquePtr<Result>> results;
+  Vector<std::exception_ptr> errors(configurations.size());
+  Vector<std::thread> threads;
+
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    results.emplace_back(std::make_unique<Result>());
+    results.back()->configuration = configurations[i];
+  }
+
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    threads.emplace_back([&, i] {
+      try {
+        EvaluateConfiguration(build_config, build_files, *results[i]);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  return results;
+}
+
+void Session::EvaluateConfiguration(const Path& build_config,
+                                    const Vector<Path>& build_files,
+                                    Result& result) {
+  Tracing::Span configuration_span("Session::EvaluateConfiguration",
+                                   result.configuration.name);
+  Evaluator evaluator;
+  if (setup_) {
+    setup_(result.configuration, evaluator);
+  }
+
+  result.global_scope = std::make_unique<Scope>();
+  for (const auto& arg : result.configuration.args) {
+    result.global_scope->Set(arg.first, arg.second);
+  }
+
+  const Optimizer args_optimizer(result.configuration.args);
+  Importer importer(loader_, cache_, *result.global_scope, source_root_);
+  importer.Register(evaluator);
+  importer.set_optimizer(&args_optimizer);
+
+  if (!build_config.empty()) {
+    Memory::File file_memory(build_config);
+    auto file = loader_.Load(build_config);
+    auto tree = cache_.Get(build_config, file->root.get(), args_optimizer);
+    Tracing::Span span("Evaluator::Execute", build_config);
+    Stats::Timer timer(evaluate_time);
+    Memory::Scope memory(Memory::SCOPES);
+    evaluator.Execute(tree->root.get(), *result.global_scope);
+    result.imports[build_config] = importer.ImportedPaths(build_config);
+  }
+
+  // The build files see the global values, that are fixed for this
+  // configuration - use them to prune the branches.
+  Optimizer::Bindings bindings;
+  for (const auto& value : result.global_scope->values()) {
+    if (value.second.type() != Value::LIST) {
+      bindings.emplace(value);
+    }
+  }
+  const Optimizer optimizer(bindings);
+  importer.set_optimizer(&optimizer);
+
+  for (const auto& build_file : build_files) {
+    if (filter_ && !filter_(result.configuration, build_file)) {
+      files_skipped.Add();
+      continue;
+    }
+
+    Memory::File file_memory(build_file);
+    auto file = loader_.Load(build_file);
+    auto tree = cache_.Get(build_file, file->root.get(), optimizer);
+    auto& scope = result.file_scopes[build_file];
+    scope = std::make_unique<Scope>(result.global_scope.get());
+    Tracing::Span span("Evaluator::Execute", build_file);
+    Stats::Timer timer(evaluate_time);
+    files_evaluated.Add();
+    Memory::Scope memory(Memory::SCOPES);
+    evaluator.Execute(tree->root.get(), *scope);
+    result.imports[build_file] = importer.ImportedPaths(build_file);
+  }
+}
+
+}  // namespace shinobi::language::shi
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <language/shi/evaluator.hh>
+#include <language/shi/loader.hh>
+#include <language/shi/optimizer.hh>
+
+namespace shinobi::language::shi {
+
+struct Configuration {
+  String name;
+  Scope::Values args;  // Override the defaults from |declare_args()|.
+};
+
+// Evaluates the same build files for several configurations concurrently:
+// every file is loaded and parsed only once, and each configuration gets its
+// own scopes over the shared syntax trees. The imported files are evaluated
+// once per configuration - see |Importer|.
+class Session {
+ public:
+  // Called from the configuration's thread before any evaluation - to
+  // register the functions, that store configuration-specific results.
+  using Setup = std::function<void(const Configuration&, Evaluator&)>;
+
+  // Returns false for the build files, that shouldn't be evaluated for the
+  // configuration, e.g. if their results are known from the previous run.
+  using Filter =
+      std::function<bool(const Configuration&, const Path& build_file)>;
+
+  struct Result {
+    Configuration configuration;
+    UniquePtr<Scope> global_scope;  // The args and the build config.
+    Map<Path, UniquePtr<Scope>> file_scopes;
+    // The files imported by the build config and by each build file - for the
+    // dependency tracking.
+    Map<Path, Vector<Path>> imports;
+  };
+
+  // The imports like "//build/foo.shi" are resolved against |source_root|.
+  explicit Session(Loader& loader, Setup setup = Setup(),
+                   Filter filter = Filter(), const Path& source_root = Path());
+
+  // The |build_config| is executed in the global scope of each configuration,
+  // then every build file is executed in its own child scope. Rethrows the
+  // first error of any configuration.
+  THREAD_SAFE Vector<UniquePtr<Result>> Evaluate(
+      const Path& build_config, const Vector<Path>& build_files,
+      const Vector<Configuration>& configurations);
+
+ private:
+  void EvaluateConfiguration(const Path& build_config,
+                             const Vector<Path>& build_files,
+                             Result& result);
+
+  Loader& loader_;
+  const Setup setup_;
+  const Filter filter_;
+  const Path source_root_;
+  OptimizedTreeCache cache_;
+};
+
+}  // namespace shinobi::language::shi
@@ -0,0 +1,170 @@
+#include <language/shi/exception.hh>
+#include <language/shi/session.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(atomic)
+#include STL(fstream)
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace shinobi::language::shi {
+
+class SessionShi : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/session_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    dir = temp_dir;
+  }
+
+  void TearDown() override {
+    for (const auto& file : files) {
+      unlink(file.c_str());
+    }
+    rmdir(dir.c_str());
+  }
+
+  Path Write(const String& name, const String& contents) {
+    files.push_back(dir + "/" + name);
+    std::ofstream(files.back()) << contents;
+    return files.back();
+  }
+
+  Path dir;
+  Vector<Path> files;
+};
+
+TEST_F(SessionShi, MultipleConfigurations) {
+  auto build_config = Write("BUILDCONFIG.shi",
+                            "declare_args() {\n"
+                            "  is_debug = false\n"
+                            "}\n"
+                            "if (is_debug) {\n"
+                            "  opt = \"-O0\"\n"
+                            "} else {\n"
+                            "  opt = \"-O3\"\n"
+                            "}\n");
+  auto build_file = Write("BUILD.shi",
+                          "flags = [ opt ]\n"
+                          "if (is_debug) {\n"
+                          "  flags += [ \"-g\" ]\n"
+                          "}\n");
+
+  Loader loader;
+  ui32 setup_calls = 0;
+  std::mutex mutex;
+  Session session(loader, [&](const Configuration&, Evaluator&) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++setup_calls;
+  });
+
+  auto results =
+      session.Evaluate(build_config, {build_file},
+                       {{"Debug", {{"is_debug", Value(true)}}},
+                        {"Release", {}},
+                        {"Test", {{"is_debug", Value(true)}}}});
+
+  EXPECT_EQ(3u, setup_calls);
+  ASSERT_EQ(3u, results.size());
+  EXPECT_EQ("Debug", results[0]->configuration.name);
+  EXPECT_EQ(Value(Value::Items{Value("-O0"), Value("-g")}),
+            *results[0]->file_scopes[build_file]->Get("flags"));
+  EXPECT_EQ(Value(Value::Items{Value("-O3")}),
+            *results[1]->file_scopes[build_file]->Get("flags"));
+  EXPECT_EQ(*results[0]->file_scopes[build_file]->Get("flags"),
+            *results[2]->file_scopes[build_file]->Get("flags"));
+
+  // The files are parsed only once.
+  EXPECT_EQ(loader.Load(build_file), loader.Load(build_file));
+}
+
+TEST_F(SessionShi, RethrowErrors) {
+  auto build_file = Write("BUILD.shi", "a = undefined\n");
+
+  Loader loader;
+  Session session(loader);
+  EXPECT_THROW(session.Evaluate(Path(), {build_file}, {{"Debug", {}}}),
+               SemanticError);
+  EXPECT_THROW(session.Evaluate(Path(), {dir + "/missing.shi"}, {{"A", {}}}),
+               LoadError);
+}
+
+TEST_F(SessionShi, Imports) {
+  auto build_config = Write("BUILDCONFIG.shi", "is_debug = false\n");
+  Write("common.shi",
+        "count()\n"
+        "declare_args() {\n"
+        "  use_lto = false\n"
+        "}\n"
+        "cflags = [ \"-Wall\" ]\n");
+  Write("wrapper.shi", "import(\"common.shi\")\n");
+  auto first = Write("first.shi",
+                     "import(\"common.shi\")\n"
+                     "cflags += [ \"-g\" ]\n");
+  auto second = Write("second.shi",
+                      "import(\"//wrapper.shi\")\n"
+                      "import(\"common.shi\")\n"
+                      "flags = cflags\n");
+
+  Loader loader;
+  std::atomic<ui32> count(0);
+  Session session(loader,
+                  [&](const Configuration&, Evaluator& evaluator) {
+                    evaluator.RegisterFunction(
+                        "count", [&](Scope&, const CallNode*, Vector<Value>&,
+                                     Scope*) {
+                          ++count;
+                          return Value();
+                        });
+                  },
+                  Session::Filter(), dir);
+
+  auto results =
+      session.Evaluate(build_config, {first, second},
+                       {{"A", {{"use_lto", Value(true)}}}, {"B", {}}});
+
+  // Once per configuration.
+  EXPECT_EQ(2u, count);
+  ASSERT_EQ(2u, results.size());
+
+  const auto& scopes = results[0]->file_scopes;
+  EXPECT_EQ(Value(Value::Items{Value("-Wall"), Value("-g")}),
+            *scopes.at(first)->Get("cflags"));
+  EXPECT_EQ(Value(Value::Items{Value("-Wall")}),
+            *scopes.at(second)->Get("flags"));
+  EXPECT_EQ(Value(true), *scopes.at(second)->Get("use_lto"));
+  EXPECT_EQ(Value(false), *results[1]->file_scopes.at(second)->Get("use_lto"));
+
+  // The modified value is copied - the imported one is shared.
+  EXPECT_EQ(scopes.at(first)->imports(), scopes.at(second)->imports()[0]
+                                             ->imports());
+  EXPECT_EQ(Value(Value::Items{Value("-Wall")}),
+            *scopes.at(first)->imports()[0]->Get("cflags"));
+
+  EXPECT_EQ(Vector<Path>{dir + "/common.shi"}, results[0]->imports[first]);
+  EXPECT_EQ(Vector<Path>({dir + "/common.shi", dir + "/wrapper.shi"}),
+            results[0]->imports[second]);
+}
+
+TEST_F(SessionShi, ImportErrors) {
+  auto cycle = Write("cycle.shi", "import(\"cycle.shi\")\n");
+  auto collision = Write("collision.shi",
+                         "cflags = [ \"-O2\" ]\n"
+                         "import(\"common.shi\")\n");
+  Write("common.shi", "cflags = [ \"-Wall\" ]\n");
+
+  Loader loader;
+  Session session(loader);
+  EXPECT_THROW(session.Evaluate(Path(), {cycle}, {{"A", {}}}), SemanticError);
+  EXPECT_THROW(session.Evaluate(Path(), {collision}, {{"A", {}}}),
+               SemanticError);
+  EXPECT_THROW(
+      session.Evaluate(Path(), {Write("root.shi", "import(\"//a.shi\")\n")},
+                       {{"A", {}}}),
+      SemanticError);
+}
+
+}  // namespace shinobi::language::shi
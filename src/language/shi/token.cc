@@ -51,10 +51,48 @@ String Token::PrintType(Token::Type type) {
       return "addition";
     case MINUS:
       return "substraction";
-    default:
-      // TODO: add strings for all types.
-      return "TODO:UNKNOWN";
+    case PLUS_EQUALS:
+      return "addition assignment";
+    case MINUS_EQUALS:
+      return "substraction assignment";
+    case EQUAL_EQUAL:
+      return "equality";
+    case NOT_EQUAL:
+      return "inequality";
+    case LESS_EQUAL:
+      return "\"<=\" comparison";
+    case GREATER_EQUAL:
+      return "\">=\" comparison";
+    case STRICTLY_LESS:
+      return "\"<\" comparison";
+    case STRICTLY_GREATER:
+      return "\">\" comparison";
+    case BOOLEAN_AND:
+      return "logical \"and\"";
+    case BOOLEAN_OR:
+      return "logical \"or\"";
+    case DOT:
+      return "scope access";
+    case LEFT_PAREN:
+      return "left parenthesis";
+    case RIGHT_PAREN:
+      return "right parenthesis";
+    case LEFT_BRACKET:
+      return "left bracket";
+    case RIGHT_BRACKET:
+      return "right bracket";
+    case LEFT_BRACE:
+      return "left brace";
+    case RIGHT_BRACE:
+      return "right brace";
+    case COMMENT:
+      return "comment";
+    case TYPE_SIZE:
+      break;
   }
+
+  NOTREACHED();
+  return String();
 }
 
 // static
@@ -141,7 +179,7 @@ Token::Token(const Location& location, Type type, const String& value)
 
 LocationRange Token::range() const {
   return LocationRange(location_,
-                       Location(location_.file_path(), location_.line(),
+                       Location(location_.file_id(), location_.line(),
                                 location_.column() + value().size(),
                                 location_.byte() + value().size()));
 }
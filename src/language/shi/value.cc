@@ -0,0 +1,323 @@
+#include <language/shi/value.hh>
+
+#include <base/assert.hh>
+#include <language/shi/exception.hh>
+
+#include STL(algorithm)
+#include STL(unordered_set)
+
+namespace shinobi::language::shi {
+
+namespace {
+
+// Smaller lists are removed by a linear search - it's faster than hashing.
+constexpr size_t kMaxLinearRemoval = 8;
+
+}  // namespace
+
+Value::Value(bool boolean) : type_(BOOLEAN), boolean_(boolean) {}
+
+Value::Value(i64 integer) : type_(INTEGER), integer_(integer) {}
+
+Value::Value(const String& string) : type_(STRING), string_(string) {}
+
+Value::Value(Items&& list)
+    : type_(LIST), list_(std::make_shared<Items>(std::move(list))) {}
+
+// static
+Value Value::FromLiteral(const Token& literal) {
+  switch (literal.type()) {
+    case Token::TRUE_TOKEN:
+      return Value(true);
+    case Token::FALSE_TOKEN:
+      return Value(false);
+    case Token::INTEGER:
+      try {
+        return Value(static_cast<i64>(std::stoll(literal.value())));
+      } catch (const std::out_of_range&) {
+        throw SemanticError(literal.location(), "Integer is out of range");
+      }
+    case Token::STRING:
+      DCHECK(literal.value().size() >= 2);
+      return Value(literal.value().substr(1, literal.value().size() - 2));
+    default:
+      NOTREACHED();
+  }
+
+  return Value();
+}
+
+bool Value::boolean() const {
+  CHECK(type_ == BOOLEAN);
+  return boolean_;
+}
+
+i64 Value::integer() const {
+  CHECK(type_ == INTEGER);
+  return integer_;
+}
+
+const String& Value::string() const {
+  CHECK(type_ == STRING);
+  return string_;
+}
+
+const Value::Items& Value::list() const {
+  CHECK(type_ == LIST);
+  return *list_;
+}
+
+bool Value::operator==(const Value& other) const {
+  if (type_ != other.type_) {
+    return false;
+  }
+
+  switch (type_) {
+    case NONE:
+      return true;
+    case BOOLEAN:
+      return boolean_ == other.boolean_;
+    case INTEGER:
+      return integer_ == other.integer_;
+    case STRING:
+      return string_ == other.string_;
+    case LIST:
+      return list_ == other.list_ || *list_ == *other.list_;
+  }
+
+  NOTREACHED();
+  return false;
+}
+
+String Value::ToString() const {
+  switch (type_) {
+    case NONE:
+      return String();
+    case BOOLEAN:
+      return boolean_ ? "true" : "false";
+    case INTEGER:
+      return std::to_string(integer_);
+    case STRING:
+      return "\"" + string_ + "\"";
+    case LIST: {
+      String result = "[";
+      for (const auto& item : *list_) {
+        result += (result.size() > 1 ? ", " : " ") + item.ToString();
+      }
+      return result + (list_->empty() ? "]" : " ]");
+    }
+  }
+
+  NOTREACHED();
+  return String();
+}
+
+size_t Value::Hash() const {
+  switch (type_) {
+    case NONE:
+      return 0;
+    case BOOLEAN:
+      return std::hash<bool>()(boolean_);
+    case INTEGER:
+      return std::hash<i64>()(integer_);
+    case STRING:
+      return std::hash<String>()(string_);
+    case LIST: {
+      size_t hash = list_->size();
+      for (const auto& item : *list_) {
+        hash ^= item.Hash() + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+  }
+
+  NOTREACHED();
+  return 0;
+}
+
+// static
+bool Value::Apply(Token::Type op, const Value& left, const Value& right,
+                  Value& result) {
+  if (left.type_ != right.type_) {
+    return false;
+  }
+
+  const auto type = left.type_;
+
+  switch (op) {
+    case Token::PLUS:
+      if (type == INTEGER) {
+        i64 sum;
+        if (__builtin_add_overflow(left.integer_, right.integer_, &sum)) {
+          return false;
+        }
+        result = Value(sum);
+        return true;
+      } else if (type == STRING) {
+        result = Value(left.string_ + right.string_);
+        return true;
+      } else if (type == LIST) {
+        result = left;
+        return result.ApplyInPlace(op, right);
+      }
+      return false;
+
+    case Token::MINUS:
+      if (type == INTEGER) {
+        i64 difference;
+        if (__builtin_sub_overflow(left.integer_, right.integer_,
+                                   &difference)) {
+          return false;
+        }
+        result = Value(difference);
+        return true;
+      } else if (type == LIST) {
+        result = left;
+        return result.ApplyInPlace(op, right);
+      }
+      return false;
+
+    case Token::EQUAL_EQUAL:
+      result = Value(left == right);
+      return true;
+
+    case Token::NOT_EQUAL:
+      result = Value(left != right);
+      return true;
+
+    case Token::LESS_EQUAL:
+      if (type != INTEGER) {
+        return false;
+      }
+      result = Value(left.integer_ <= right.integer_);
+      return true;
+
+    case Token::GREATER_EQUAL:
+      if (type != INTEGER) {
+        return false;
+      }
+      result = Value(left.integer_ >= right.integer_);
+      return true;
+
+    case Token::STRICTLY_LESS:
+      if (type != INTEGER) {
+        return false;
+      }
+      result = Value(left.integer_ < right.integer_);
+      return true;
+
+    case Token::STRICTLY_GREATER:
+      if (type != INTEGER) {
+        return false;
+      }
+      result = Value(left.integer_ > right.integer_);
+      return true;
+
+    case Token::BOOLEAN_AND:
+      if (type != BOOLEAN) {
+        return false;
+      }
+      result = Value(left.boolean_ && right.boolean_);
+      return true;
+
+    case Token::BOOLEAN_OR:
+      if (type != BOOLEAN) {
+        return false;
+      }
+      result = Value(left.boolean_ || right.boolean_);
+      return true;
+
+    default:
+      NOTREACHED();
+  }
+
+  return false;
+}
+
+bool Value::ApplyInPlace(Token::Type op, const Value& right) {
+  if (type_ != LIST || right.type_ != LIST) {
+    Value result;
+    if (!Apply(op, *this, right, result)) {
+      return false;
+    }
+    *this = std::move(result);
+    return true;
+  }
+
+  // Keep the right items alive - they may be the same as the left ones.
+  const auto right_list = right.list_;
+
+  if (op == Token::PLUS) {
+    if (right_list->empty()) {
+      return true;
+    }
+    auto& list = MutableList();
+    list.insert(list.end(), right_list->begin(), right_list->end());
+    return true;
+  }
+
+  if (op != Token::MINUS) {
+    return false;
+  }
+
+  const auto& removed = *right_list;
+  if (removed.empty()) {
+    return true;
+  }
+
+  if (removed.size() <= kMaxLinearRemoval) {
+    auto is_removed = [&removed](const Value& item) {
+      return std::find(removed.begin(), removed.end(), item) != removed.end();
+    };
+    if (std::any_of(list_->begin(), list_->end(), is_removed)) {
+      auto& list = MutableList();
+      list.erase(std::remove_if(list.begin(), list.end(), is_removed),
+                 list.end());
+    }
+    return true;
+  }
+
+  const std::unordered_set<Value, Hasher> removed_set(removed.begin(),
+                                                      removed.end());
+  auto is_removed = [&removed_set](const Value& item) {
+    return removed_set.count(item) != 0;
+  };
+  if (std::any_of(list_->begin(), list_->end(), is_removed)) {
+    auto& list = MutableList();
+    list.erase(std::remove_if(list.begin(), list.end(), is_removed),
+               list.end());
+  }
+  return true;
+}
+
+// static
+String Value::PrintType(Type type) {
+  switch (type) {
+    case NONE:
+      return "none";
+    case BOOLEAN:
+      return "boolean";
+    case INTEGER:
+      return "integer";
+    case STRING:
+      return "string";
+    case LIST:
+      return "list";
+  }
+
+  NOTREACHED();
+  return String();
+}
+
+Value::Items& Value::MutableList() {
+  DCHECK(type_ == LIST);
+
+  // A value is modified only by the thread, that owns it - so the only owner
+  // can't gain the new copies concurrently.
+  if (list_.use_count() != 1) {
+    list_ = std::make_shared<Items>(*list_);
+  }
+  return *list_;
+}
+
+}  // namespace shinobi::language::shi
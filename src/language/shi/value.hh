@@ -0,0 +1,73 @@
+#pragma once
+
+#include <language/shi/token.hh>
+
+namespace shinobi::language::shi {
+
+class Value {
+ public:
+  enum Type {
+    NONE,
+    BOOLEAN,
+    INTEGER,
+    STRING,
+    LIST,
+  };
+
+  using Items = Vector<Value>;
+
+  struct Hasher {
+    size_t operator()(const Value& value) const { return value.Hash(); }
+  };
+
+  Value() = default;
+  explicit Value(bool boolean);
+  explicit Value(i64 integer);
+  explicit Value(const char* string) : Value(String(string)) {}
+  explicit Value(const String& string);
+  explicit Value(Items&& list);
+
+  // Converts literal token to a value - strips quotes from strings.
+  static Value FromLiteral(const Token& literal);
+
+  inline Type type() const { return type_; }
+
+  bool boolean() const;
+  i64 integer() const;
+  const String& string() const;
+  const Items& list() const;
+
+  bool operator==(const Value& other) const;
+  bool operator!=(const Value& other) const { return !(*this == other); }
+
+  // Returns the value as it should be written in the source code.
+  String ToString() const;
+
+  // Consistent with |operator==|.
+  size_t Hash() const;
+
+  // Applies the binary operation to the operands of the matching types.
+  // Returns false if the operation isn't applicable to the operands.
+  static bool Apply(Token::Type op, const Value& left, const Value& right,
+                    Value& result);
+
+  // Like |Apply()|, but modifies the left operand - for "+=" and "-=". The
+  // copies of a list share its items until one of them is modified, then the
+  // items are copied once - so a chain of appends to the same variable takes
+  // amortized O(1) time per item.
+  bool ApplyInPlace(Token::Type op, const Value& right);
+
+  static String PrintType(Type type);
+
+ private:
+  Type type_ = NONE;
+  bool boolean_ = false;
+  i64 integer_ = 0;
+  String string_;
+  SharedPtr<Items> list_;  // Shared between the copies.
+
+  // Returns the items, which aren't shared with any other value.
+  Items& MutableList();
+};
+
+}  // namespace shinobi::language::shi
@@ -0,0 +1,73 @@
+#include <output/build_paths.hh>
+
+namespace shinobi::output {
+
+BuildPaths::BuildPaths(const Path& source_root, const Path& build_dir) {
+  if (build_dir.compare(0, source_root.size() + 1, source_root + "/") == 0) {
+    // The usual case: the build directory is inside the sources.
+    for (size_t i = source_root.size(); i < build_dir.size(); ++i) {
+      if (build_dir[i] == '/' && i + 1 < build_dir.size()) {
+        source_prefix_ += "../";
+      }
+    }
+  } else {
+    source_prefix_ = source_root + "/";
+  }
+}
+
+String BuildPaths::SourcePath(const Path& source, const Path& dir) const {
+  Path path;
+  if (!ResolvePath(source, dir, path)) {
+    // Goes above the source root - keep it as is.
+    path = dir + (dir.size() > 2 ? "/" : "") + source;
+  }
+
+  if (path.compare(0, 2, "//") == 0) {
+    return source_prefix_ + path.substr(2);
+  }
+  return path;
+}
+
+// static
+String BuildPaths::ObjectDir(const Label& label) {
+  return "obj/" + label.dir().substr(2) + (label.dir().size() > 2 ? "/" : "");
+}
+
+// static
+String BuildPaths::ObjectPath(const Label& label, const Path& source) {
+  Path path;
+  if (!ResolvePath(source, label.dir(), path)) {
+    // Goes above the source root - in the target's directory then.
+    path = label.dir() + (label.dir().size() > 2 ? "/" : "") +
+           source.substr(source.rfind('/') + 1);
+  }
+
+  // Like GN's "{{source_out_dir}}" - the sources of the same name in different
+  // directories don't collide.
+  const auto slash = path.rfind('/');
+  String dir;
+  if (path.compare(0, 2, "//") == 0) {
+    dir = slash > 1 ? "obj/" + path.substr(2, slash - 2) + "/" : "obj/";
+  } else {
+    dir = "obj/ABS_PATH" + path.substr(0, slash + 1);
+  }
+
+  auto base_name = path.substr(slash + 1);
+  base_name = base_name.substr(0, base_name.rfind('.'));
+  return dir + label.name() + "." + base_name + ".o";
+}
+
+// static
+bool BuildPaths::IsCompiled(const Path& source, bool& is_c) {
+  const auto dot = source.rfind('.');
+  if (dot == String::npos) {
+    return false;
+  }
+
+  const auto extension = source.substr(dot + 1);
+  is_c = extension == "c";
+  return is_c || extension == "cc" || extension == "cpp" ||
+         extension == "cxx";
+}
+
+}  // namespace shinobi::output
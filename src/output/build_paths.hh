@@ -0,0 +1,34 @@
+#pragma once
+
+#include <base/label.hh>
+#include <base/path.hh>
+
+namespace shinobi::output {
+
+// The layout of the build directory, shared by the writers: the paths of the
+// sources and the objects relative to it. Not escaped.
+class BuildPaths {
+ public:
+  // Both are absolute.
+  BuildPaths(const Path& source_root, const Path& build_dir);
+
+  // Returns the path relative to the build directory. The |source| is relative
+  // to the |dir|, like "//src/base".
+  String SourcePath(const Path& source, const Path& dir) const;
+
+  // Like "obj/src/base/", or "obj/" for the root directory.
+  static String ObjectDir(const Label& label);
+
+  // Like "obj/src/base/base.file.o" for the source "file.cc" of "//src/base",
+  // or "obj/src/base/win/base.file.o" for "win/file.cc" - in the directory of
+  // the source.
+  static String ObjectPath(const Label& label, const Path& source);
+
+  // Returns true, if the source is compiled - as C or as C++.
+  static bool IsCompiled(const Path& source, bool& is_c);
+
+ private:
+  String source_prefix_;  // From the build directory to the source root.
+};
+
+}  // namespace shinobi::output
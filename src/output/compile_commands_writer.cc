@@ -0,0 +1,141 @@
+#include <output/compile_commands_writer.hh>
+
+#include <base/json.hh>
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <output/escape.hh>
+#include <output/output_file.hh>
+#include <output/variables.hh>
+
+namespace shinobi::output {
+
+using graph::Target;
+using language::shi::Value;
+
+namespace {
+
+const Stats::Counter entries_written("output.compile_commands");
+const Stats::Counter write_time("time.write_compile_commands",
+                                Stats::MICROSECONDS);
+
+// Appends the contents of the JSON string - without the quotes.
+void AppendJsonContents(const String& str, String& output) {
+  const auto begin = output.size();
+  AppendJsonString(str.data(), str.size(), output);
+  output.erase(begin, 1);
+  output.pop_back();
+}
+
+void AppendFlags(const char* prefix, const Value::Items& values,
+                 String& output) {
+  for (const auto& value : values) {
+    if (value.type() == Value::STRING) {
+      output += ' ';
+      EscapeShellArgument(prefix + value.string(), output);
+    }
+  }
+}
+
+}  // namespace
+
+CompileCommandsWriter::CompileCommandsWriter(
+    const graph::Graph& graph, const NinjaWriter::Options& options)
+    : graph_(graph),
+      options_(options),
+      build_paths_(options.source_root, options.build_dir),
+      directory_(JsonString(options.build_dir)) {}
+
+bool CompileCommandsWriter::Write(ThreadPool& pool) {
+  Tracing::Span span("CompileCommandsWriter::Write");
+  Stats::Timer timer(write_time);
+  Memory::Scope memory(Memory::OUTPUT);
+
+  Vector<String> chunks(graph_.size());
+  for (Index i = 0; i < graph_.size(); ++i) {
+    pool.Push([this, i, &chunks] {
+      Memory::Scope target_memory(Memory::OUTPUT);
+      WriteTarget(i, chunks[i]);
+    });
+  }
+  pool.Wait();
+
+  size_t size = 4;
+  for (const auto& chunk : chunks) {
+    size += chunk.size();
+  }
+
+  OutputFile file(options_.build_dir + "/" + kFileName, size);
+  file << "[\n";
+  for (auto& chunk : chunks) {
+    file << chunk;
+    String().swap(chunk);
+  }
+  if (file.contents().size() > 2) {
+    file.contents().resize(file.contents().size() - 2);  // The last ",\n".
+    file << '\n';
+  }
+  file << "]\n";
+
+  return file.Commit();
+}
+
+void CompileCommandsWriter::WriteTarget(Index index, String& output) const {
+  const auto& target = graph_.target(index);
+  const auto& label = target.label();
+
+  // The common flags of C and C++, then the specific ones - escaped for the
+  // JSON, once each.
+  String flags, c_command, cxx_command;
+  AppendFlags("-D", GetList(target, "defines"), flags);
+  // Relative to the target's directory, like the sources.
+  for (const auto& include_dir : GetList(target, "include_dirs")) {
+    if (include_dir.type() == Value::STRING) {
+      flags += ' ';
+      EscapeShellArgument(
+          "-I" + build_paths_.SourcePath(include_dir.string(), label.dir()),
+          flags);
+    }
+  }
+  AppendFlags("", GetList(target, "cflags"), flags);
+
+  for (const auto& source : GetList(target, "sources")) {
+    bool is_c;
+    if (source.type() != Value::STRING ||
+        !BuildPaths::IsCompiled(source.string(), is_c)) {
+      continue;
+    }
+
+    auto& command = is_c ? c_command : cxx_command;
+    if (command.empty()) {
+      String line = is_c ? options_.cc : options_.cxx;
+      line += flags;
+      AppendFlags("", GetList(target, is_c ? "cflags_c" : "cflags_cc"), line);
+      AppendJsonContents(line, command);
+    }
+
+    const auto source_path =
+        build_paths_.SourcePath(source.string(), label.dir());
+    const auto object_path = BuildPaths::ObjectPath(label, source.string());
+
+    String arguments = " -c ";
+    EscapeShellArgument(source_path, arguments);
+    arguments += " -o ";
+    EscapeShellArgument(object_path, arguments);
+
+    output += "  {\"directory\": ";
+    output += directory_;
+    output += ", \"command\": \"";
+    output += command;
+    AppendJsonContents(arguments, output);
+    output += "\", \"file\": ";
+    AppendJsonString(source_path.data(), source_path.size(), output);
+    output += ", \"output\": ";
+    AppendJsonString(object_path.data(), object_path.size(), output);
+    output += "},\n";
+
+    entries_written.Add();
+  }
+}
+
+}  // namespace shinobi::output
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <base/thread_pool.hh>
+#include <graph/graph.hh>
+#include <output/build_paths.hh>
+#include <output/ninja_writer.hh>
+
+namespace shinobi::output {
+
+// Writes the "compile_commands.json" of the build directory - the compilation
+// database for the IDEs and the tools like clang-tidy. The commands are the
+// ones of the Ninja files, written with the same options.
+//
+// The entries are formatted straight into the JSON text - a chunk per target,
+// in parallel - and the chunks are concatenated in the order of the targets.
+// The flags of a target are escaped once and shared by all its entries.
+class CompileCommandsWriter {
+ public:
+  static constexpr const char* kFileName = "compile_commands.json";
+
+  CompileCommandsWriter(const graph::Graph& graph,
+                        const NinjaWriter::Options& options);
+
+  // Returns true, if the file actually changed.
+  bool Write(ThreadPool& pool);
+
+ private:
+  using Index = graph::Graph::Index;
+
+  // Appends the entries of the target's sources, each followed by ",\n".
+  void WriteTarget(Index index, String& output) const;
+
+  const graph::Graph& graph_;
+  const NinjaWriter::Options options_;
+  const BuildPaths build_paths_;
+  String directory_;  // The escaped JSON string.
+};
+
+}  // namespace shinobi::output
@@ -0,0 +1,106 @@
+#include <graph/builder.hh>
+#include <language/shi/loader.hh>
+#include <output/compile_commands_writer.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+#include STL(sstream)
+
+#include <stdlib.h>
+
+namespace shinobi::output {
+
+using namespace language::shi;
+
+class CompileCommandsWriterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/compile_commands_writer_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    root = temp_dir;
+  }
+
+  void TearDown() override {
+    ASSERT_EQ(0, system(("rm -rf " + root).c_str()));
+  }
+
+  UniquePtr<graph::Graph> Build(const String& input) {
+    graph::Builder builder(root);
+    Evaluator evaluator;
+    builder.Register(evaluator);
+
+    auto file = Loader::Parse(root + "/src/BUILD.shi", input);
+    Scope scope;
+    evaluator.Execute(file->root.get(), scope);
+    return builder.Build();
+  }
+
+  String Read() {
+    std::ifstream stream(root + "/out/compile_commands.json");
+    std::stringstream contents;
+    contents << stream.rdbuf();
+    return contents.str();
+  }
+
+  Path root;
+};
+
+TEST_F(CompileCommandsWriterTest, WriteEntries) {
+  auto graph = Build(
+      "executable(\"app\") {\n"
+      "  sources = [ \"main.cc\", \"util.h\", \"c.c\" ]\n"
+      "  deps = [ \":set\" ]\n"
+      "  defines = [ \"NAME=a b\" ]\n"
+      "  include_dirs = [ \"include\" ]\n"
+      "  cflags = [ \"-O2\" ]\n"
+      "  cflags_cc = [ \"-std=c++17\" ]\n"
+      "}\n"
+      "source_set(\"set\") {\n"
+      "  sources = [ \"//common/set one.cc\" ]\n"
+      "}\n"
+      "group(\"empty\") {\n"
+      "}\n");
+
+  NinjaWriter::Options options;
+  options.source_root = root;
+  options.build_dir = root + "/out";
+
+  ThreadPool pool(4);
+  EXPECT_TRUE(CompileCommandsWriter(*graph, options).Write(pool));
+
+  const String directory = "{\"directory\": \"" + root + "/out\", ";
+  const String flags = " '-DNAME=a b' -I../src/include -O2";
+  EXPECT_EQ(
+      "[\n"
+      "  " + directory + "\"command\": \"clang++" + flags +
+      " -std=c++17 -c ../src/main.cc -o obj/src/app.main.o\", "
+      "\"file\": \"../src/main.cc\", \"output\": \"obj/src/app.main.o\"},\n"
+      "  " + directory + "\"command\": \"clang" + flags +
+      " -c ../src/c.c -o obj/src/app.c.o\", "
+      "\"file\": \"../src/c.c\", \"output\": \"obj/src/app.c.o\"},\n"
+      "  " + directory + "\"command\": \"clang++ -c "
+      "'../common/set one.cc' -o 'obj/common/set.set one.o'\", "
+      "\"file\": \"../common/set one.cc\", "
+      "\"output\": \"obj/common/set.set one.o\"}\n"
+      "]\n",
+      Read());
+
+  // Nothing changed - nothing is written.
+  EXPECT_FALSE(CompileCommandsWriter(*graph, options).Write(pool));
+}
+
+TEST_F(CompileCommandsWriterTest, NoSources) {
+  auto graph = Build("group(\"empty\") {\n}\n");
+
+  NinjaWriter::Options options;
+  options.source_root = root;
+  options.build_dir = root + "/out";
+
+  ThreadPool pool(2);
+  EXPECT_TRUE(CompileCommandsWriter(*graph, options).Write(pool));
+  EXPECT_EQ("[\n]\n", Read());
+}
+
+}  // namespace shinobi::output
@@ -0,0 +1,83 @@
+#include <output/escape.hh>
+
+#include STL(stdexcept)
+
+namespace shinobi::output {
+
+namespace {
+
+// Anything but the characters, that no shell treats specially, is quoted:
+// e.g. "$", "#", "~", "!", the globs and the newlines.
+bool NeedsShellQuoting(const String& argument) {
+  for (const char c : argument) {
+    const bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                      (c >= '0' && c <= '9') || c == '_' || c == '.' ||
+                      c == '/' || c == '=' || c == '+' || c == ':' ||
+                      c == ',' || c == '@' || c == '%' || c == '-';
+    if (!safe) {
+      return true;
+    }
+  }
+
+  return argument.empty();
+}
+
+// Ninja has no escape for the newline - it would end the line.
+void CheckNoNewline(const String& text) {
+  if (text.find('\n') != String::npos) {
+    throw std::invalid_argument("A newline can't be written to Ninja: \"" +
+                                text + "\"");
+  }
+}
+
+}  // namespace
+
+void EscapeNinjaPath(const String& path, String& output) {
+  CheckNoNewline(path);
+  for (const char c : path) {
+    if (c == '$' || c == ' ' || c == ':') {
+      output.push_back('$');
+    }
+    output.push_back(c);
+  }
+}
+
+void EscapeNinjaArgument(const String& argument, String& output) {
+  CheckNoNewline(argument);
+  const bool quote = NeedsShellQuoting(argument);
+
+  if (quote) {
+    output.push_back('\'');
+  }
+
+  for (const char c : argument) {
+    if (c == '$') {
+      output.push_back('$');
+    } else if (quote && c == '\'') {
+      output.append("'\\'");
+    }
+    output.push_back(c);
+  }
+
+  if (quote) {
+    output.push_back('\'');
+  }
+}
+
+void EscapeShellArgument(const String& argument, String& output) {
+  if (!NeedsShellQuoting(argument)) {
+    output.append(argument);
+    return;
+  }
+
+  output.push_back('\'');
+  for (const char c : argument) {
+    if (c == '\'') {
+      output.append("'\\'");
+    }
+    output.push_back(c);
+  }
+  output.push_back('\'');
+}
+
+}  // namespace shinobi::output
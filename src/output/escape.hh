@@ -0,0 +1,18 @@
+#pragma once
+
+#include <base/aliases.hh>
+
+namespace shinobi::output {
+
+// Appends the path escaped for the Ninja build lines: "$", " " and ":".
+// Throws |std::invalid_argument| on the newlines - like the function below.
+void EscapeNinjaPath(const String& path, String& output);
+
+// Appends the command-line argument escaped for the Ninja variables and quoted
+// for the shell, if needed.
+void EscapeNinjaArgument(const String& argument, String& output);
+
+// Appends the command-line argument quoted for the shell, if needed.
+void EscapeShellArgument(const String& argument, String& output);
+
+}  // namespace shinobi::output
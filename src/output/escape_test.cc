@@ -0,0 +1,57 @@
+#include <output/escape.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(stdexcept)
+
+namespace shinobi::output {
+
+namespace {
+
+String Shell(const String& argument) {
+  String output;
+  EscapeShellArgument(argument, output);
+  return output;
+}
+
+String Ninja(const String& argument) {
+  String output;
+  EscapeNinjaArgument(argument, output);
+  return output;
+}
+
+}  // namespace
+
+TEST(EscapeTest, ShellArgument) {
+  EXPECT_EQ("-DNAME=value", Shell("-DNAME=value"));
+  EXPECT_EQ("-I../src/base", Shell("-I../src/base"));
+  EXPECT_EQ("-Wl,--as-needed", Shell("-Wl,--as-needed"));
+  EXPECT_EQ("''", Shell(""));
+
+  EXPECT_EQ("'-DX=$HOME'", Shell("-DX=$HOME"));
+  EXPECT_EQ("'-DX=$(id)'", Shell("-DX=$(id)"));
+  EXPECT_EQ("'-DX=`id`'", Shell("-DX=`id`"));
+  EXPECT_EQ("'#x'", Shell("#x"));
+  EXPECT_EQ("'~/include'", Shell("~/include"));
+  EXPECT_EQ("'!x'", Shell("!x"));
+  EXPECT_EQ("'x[0]'", Shell("x[0]"));
+  EXPECT_EQ("'{a,b}'", Shell("{a,b}"));
+  EXPECT_EQ("'a b'", Shell("a b"));
+  EXPECT_EQ("'a\nb'", Shell("a\nb"));
+  EXPECT_EQ("'it'\\''s'", Shell("it's"));
+}
+
+TEST(EscapeTest, NinjaArgument) {
+  EXPECT_EQ("-DNAME=value", Ninja("-DNAME=value"));
+  // Ninja gives "$HOME" to the shell - quoted.
+  EXPECT_EQ("'-DX=$$HOME'", Ninja("-DX=$HOME"));
+  EXPECT_EQ("'-DX=$$(id)'", Ninja("-DX=$(id)"));
+  EXPECT_EQ("'it'\\''s'", Ninja("it's"));
+
+  EXPECT_THROW(Ninja("-DX=a\nb"), std::invalid_argument);
+  String output;
+  EXPECT_THROW(EscapeNinjaPath("a\nb.cc", output), std::invalid_argument);
+}
+
+}  // namespace shinobi::output
@@ -0,0 +1,342 @@
+#include <output/ninja_writer.hh>
+
+#include <base/assert.hh>
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <output/escape.hh>
+#include <output/output_file.hh>
+#include <output/variables.hh>
+
+#include STL(atomic)
+#include STL(unordered_set)
+
+namespace shinobi::output {
+
+using graph::Target;
+using language::shi::Value;
+
+namespace {
+
+const Stats::Counter files_written("output.files_written");
+const Stats::Counter write_time("time.write_ninja", Stats::MICROSECONDS);
+
+void WriteVariable(OutputFile& file, const char* name, const char* prefix,
+                   const Value::Items& values) {
+  if (values.empty()) {
+    return;
+  }
+
+  file << name << " =";
+  for (const auto& value : values) {
+    if (value.type() != Value::STRING) {
+      continue;
+    }
+    file << ' ';
+    EscapeNinjaArgument(prefix + value.string(), file.contents());
+  }
+  file << '\n';
+}
+
+}  // namespace
+
+NinjaWriter::NinjaWriter(const graph::Graph& graph, const Options& options)
+    : graph_(graph),
+      options_(options),
+      build_paths_(options.source_root, options.build_dir),
+      paths_(graph.size()) {}
+
+ui32 NinjaWriter::Write(ThreadPool& pool) {
+  Tracing::Span span("NinjaWriter::Write");
+  Stats::Timer timer(write_time);
+  Memory::Scope memory(Memory::OUTPUT);
+  for (Index i = 0; i < graph_.size(); ++i) {
+    pool.Push([this, i] {
+      Memory::Scope target_memory(Memory::OUTPUT);
+      PrepareTarget(i);
+    });
+  }
+  pool.Wait();
+
+  // Group the targets by directory.
+  Map<Path, Vector<Index>> dirs;
+  for (Index i = 0; i < graph_.size(); ++i) {
+    dirs[graph_.target(i).label().dir()].push_back(i);
+  }
+
+  std::atomic<ui32> changed(0);
+  for (const auto& dir : dirs) {
+    pool.Push([this, &dir, &changed] {
+      Tracing::Span dir_span("NinjaWriter::WriteTargets", dir.first);
+      Memory::Scope dir_memory(Memory::OUTPUT);
+      for (auto index : dir.second) {
+        OutputFile file(options_.build_dir + "/" + paths_[index].ninja_file);
+        WriteTarget(index, file);
+        if (file.Commit()) {
+          ++changed;
+        }
+      }
+    });
+  }
+  pool.Wait();
+
+  Tracing::Span build_file_span("NinjaWriter::WriteBuildFile");
+  OutputFile file(options_.build_dir + "/build.ninja", 1024 * 1024);
+  WriteBuildFile(file);
+  if (file.Commit()) {
+    ++changed;
+  }
+
+  files_written.Add(changed);
+  return changed;
+}
+
+void NinjaWriter::PrepareTarget(Index index) {
+  const auto& target = graph_.target(index);
+  const auto& label = target.label();
+  const auto& name = label.name();
+  const String obj_dir = BuildPaths::ObjectDir(label);
+  auto& paths = paths_[index];
+
+  paths.ninja_file = obj_dir + name + ".ninja";
+
+  for (const auto& source : GetList(target, "sources")) {
+    if (source.type() != Value::STRING) {
+      continue;
+    }
+
+    bool is_c;
+    if (!BuildPaths::IsCompiled(source.string(), is_c)) {
+      continue;
+    }
+
+    paths.sources.emplace_back();
+    EscapeNinjaPath(build_paths_.SourcePath(source.string(), label.dir()),
+                    paths.sources.back());
+    paths.objects.emplace_back();
+    EscapeNinjaPath(BuildPaths::ObjectPath(label, source.string()),
+                    paths.objects.back());
+  }
+
+  switch (target.type()) {
+    case Target::EXECUTABLE:
+      EscapeNinjaPath(name, paths.output);
+      break;
+    case Target::SHARED_LIBRARY:
+      EscapeNinjaPath("lib" + name + ".so", paths.output);
+      break;
+    case Target::STATIC_LIBRARY:
+      EscapeNinjaPath(obj_dir + "lib" + name + ".a", paths.output);
+      break;
+    case Target::GROUP:
+    case Target::SOURCE_SET:
+      EscapeNinjaPath(obj_dir + name + ".stamp", paths.output);
+      break;
+  }
+}
+
+// The include directories are relative to the target's directory, while the
+// compiler runs in the build directory.
+void NinjaWriter::WriteIncludeDirs(OutputFile& file,
+                                   const Target& target) const {
+  const auto& include_dirs = GetList(target, "include_dirs");
+  if (include_dirs.empty()) {
+    return;
+  }
+
+  file << "include_dirs =";
+  for (const auto& include_dir : include_dirs) {
+    if (include_dir.type() != Value::STRING) {
+      continue;
+    }
+    file << ' ';
+    EscapeNinjaArgument(
+        "-I" + build_paths_.SourcePath(include_dir.string(),
+                                       target.label().dir()),
+        file.contents());
+  }
+  file << '\n';
+}
+
+void NinjaWriter::WriteTarget(Index index, OutputFile& file) const {
+  const auto& target = graph_.target(index);
+  const auto& paths = paths_[index];
+
+  file << "# Generated by shinobi for " << target.label().ToString()
+       << "\n\n";
+
+  WriteVariable(file, "defines", "-D", GetList(target, "defines"));
+  WriteIncludeDirs(file, target);
+  WriteVariable(file, "cflags", "", GetList(target, "cflags"));
+  WriteVariable(file, "cflags_c", "", GetList(target, "cflags_c"));
+  WriteVariable(file, "cflags_cc", "", GetList(target, "cflags_cc"));
+  WriteVariable(file, "ldflags", "", GetList(target, "ldflags"));
+  WriteVariable(file, "libs", "-l", GetList(target, "libs"));
+  file << '\n';
+
+  // The deps' outputs should exist before compilation, e.g. the generated
+  // headers.
+  String order_only;
+  for (auto dep : graph_.deps(index)) {
+    order_only += ' ';
+    order_only += paths_[dep].output;
+  }
+
+  for (size_t i = 0; i < paths.objects.size(); ++i) {
+    bool is_c;
+    BuildPaths::IsCompiled(paths.sources[i], is_c);
+    file << "build " << paths.objects[i] << (is_c ? ": cc " : ": cxx ")
+         << paths.sources[i];
+    if (!order_only.empty()) {
+      file << " ||" << order_only;
+    }
+    file << '\n';
+  }
+
+  file << "\nbuild " << paths.output;
+  switch (target.type()) {
+    case Target::EXECUTABLE:
+      file << ": link";
+      break;
+    case Target::SHARED_LIBRARY:
+      file << ": solink";
+      break;
+    case Target::STATIC_LIBRARY:
+      file << ": alink";
+      break;
+    case Target::GROUP:
+    case Target::SOURCE_SET:
+      file << ": stamp";
+      break;
+  }
+
+  for (const auto& object : paths.objects) {
+    file << ' ' << object;
+  }
+
+  if (target.type() == Target::EXECUTABLE ||
+      target.type() == Target::SHARED_LIBRARY) {
+    WriteLinkInputs(index, file);
+  }
+
+  if (!order_only.empty()) {
+    file << " ||" << order_only;
+  }
+  file << '\n';
+}
+
+// The objects of the source sets and the static libraries are linked with all
+// their deps, while the shared libraries stop the walk. Only the linked targets
+// walk their deps. The inputs are written in the reverse postorder - each
+// library before all of its deps, as the linker resolves the symbols only
+// against the archives, that follow.
+void NinjaWriter::WriteLinkInputs(Index index, OutputFile& file) const {
+  const auto walks_deps = [this](Index dep) {
+    const auto type = graph_.target(dep).type();
+    return type == Target::STATIC_LIBRARY || type == Target::SOURCE_SET ||
+           type == Target::GROUP;
+  };
+
+  // The deps are walked from the last one - so the reversed order keeps the
+  // listed one, where the deps allow.
+  std::unordered_set<Index> visited;
+  Vector<Index> postorder;
+  Vector<Pair<Index, size_t>> stack;  // With the number of the walked deps.
+  const auto deps = graph_.deps(index);
+  for (auto it = deps.end(); it != deps.begin();) {
+    if (visited.insert(*--it).second) {
+      stack.emplace_back(*it, 0);
+    }
+
+    while (!stack.empty()) {
+      const auto dep = stack.back().first;
+      const auto dep_deps =
+          walks_deps(dep) ? graph_.deps(dep) : graph::Graph::Edges(nullptr, nullptr);
+      if (stack.back().second < dep_deps.size()) {
+        const auto next = dep_deps.end()[-1 - stack.back().second++];
+        if (visited.insert(next).second) {
+          stack.emplace_back(next, 0);
+        }
+        continue;
+      }
+
+      postorder.push_back(dep);
+      stack.pop_back();
+    }
+  }
+
+  for (auto it = postorder.rbegin(); it != postorder.rend(); ++it) {
+    const auto& paths = paths_[*it];
+    switch (graph_.target(*it).type()) {
+      case Target::EXECUTABLE:
+      case Target::GROUP:
+        break;
+      case Target::SHARED_LIBRARY:
+      case Target::STATIC_LIBRARY:
+        file << ' ' << paths.output;
+        break;
+      case Target::SOURCE_SET:
+        for (const auto& object : paths.objects) {
+          file << ' ' << object;
+        }
+        break;
+    }
+  }
+}
+
+void NinjaWriter::WriteBuildFile(OutputFile& file) const {
+  const auto& cc = options_.cc;
+  const auto& cxx = options_.cxx;
+
+  file << "# Generated by shinobi - do not edit.\n\n"
+       << "ninja_required_version = 1.7.2\n\n"
+       << "rule cc\n"
+       << "  command = " << cc
+       << " -MMD -MF $out.d $defines $include_dirs $cflags $cflags_c"
+          " -c $in -o $out\n"
+       << "  description = CC $out\n"
+       << "  depfile = $out.d\n"
+       << "  deps = gcc\n\n"
+       << "rule cxx\n"
+       << "  command = " << cxx
+       << " -MMD -MF $out.d $defines $include_dirs $cflags $cflags_cc"
+          " -c $in -o $out\n"
+       << "  description = CXX $out\n"
+       << "  depfile = $out.d\n"
+       << "  deps = gcc\n\n"
+       << "rule alink\n"
+       << "  command = rm -f $out && " << options_.ar << " rcs $out $in\n"
+       << "  description = AR $out\n\n"
+       << "rule solink\n"
+       << "  command = " << cxx << " -shared $ldflags -o $out $in $libs\n"
+       << "  description = SOLINK $out\n\n"
+       << "rule link\n"
+       << "  command = " << cxx << " $ldflags -o $out $in $libs\n"
+       << "  description = LINK $out\n\n"
+       << "rule stamp\n"
+       << "  command = touch $out\n"
+       << "  description = STAMP $out\n\n";
+
+  for (const auto& paths : paths_) {
+    file << "subninja ";
+    EscapeNinjaPath(paths.ninja_file, file.contents());
+    file << '\n';
+  }
+  file << '\n';
+
+  // The short names for the targets, like "src/base:base".
+  for (Index i = 0; i < graph_.size(); ++i) {
+    file << "build ";
+    EscapeNinjaPath(graph_.target(i).label().ToString().substr(2),
+                    file.contents());
+    file << ": phony " << paths_[i].output << '\n';
+  }
+
+  file << "\nbuild all: phony";
+  for (const auto& paths : paths_) {
+    file << ' ' << paths.output;
+  }
+  file << "\n\ndefault all\n";
+}
+
+}  // namespace shinobi::output
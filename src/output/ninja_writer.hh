@@ -0,0 +1,53 @@
+#pragma once
+
+#include <base/thread_pool.hh>
+#include <graph/graph.hh>
+#include <output/build_paths.hh>
+
+namespace shinobi::output {
+
+class OutputFile;
+
+// Writes the "build.ninja" with the rules and a separate ".ninja" file per
+// target. All the paths are escaped only once per target and reused by the
+// dependent targets.
+class NinjaWriter {
+ public:
+  struct Options {
+    Path source_root;  // Absolute.
+    Path build_dir;    // Absolute.
+
+    String cc = "clang";
+    String cxx = "clang++";
+    String ar = "ar";
+  };
+
+  NinjaWriter(const graph::Graph& graph, const Options& options);
+
+  // The target files are written in parallel - one task per directory.
+  // Returns the number of the files, that actually changed.
+  ui32 Write(ThreadPool& pool);
+
+ private:
+  using Index = graph::Graph::Index;
+
+  // The escaped paths relative to the build directory.
+  struct TargetPaths {
+    String ninja_file;  // Not escaped.
+    String output;
+    Vector<String> sources, objects;
+  };
+
+  void PrepareTarget(Index index);
+  void WriteTarget(Index index, OutputFile& file) const;
+  void WriteLinkInputs(Index index, OutputFile& file) const;
+  void WriteIncludeDirs(OutputFile& file, const graph::Target& target) const;
+  void WriteBuildFile(OutputFile& file) const;
+
+  const graph::Graph& graph_;
+  const Options options_;
+  const BuildPaths build_paths_;
+  Vector<TargetPaths> paths_;
+};
+
+}  // namespace shinobi::output
@@ -0,0 +1,160 @@
+#include <graph/builder.hh>
+#include <language/shi/loader.hh>
+#include <output/ninja_writer.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+#include STL(sstream)
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace shinobi::output {
+
+using namespace language::shi;
+
+class NinjaWriterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/ninja_writer_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    root = temp_dir;
+  }
+
+  void TearDown() override {
+    ASSERT_EQ(0, system(("rm -rf " + root).c_str()));
+  }
+
+  UniquePtr<graph::Graph> Build(const String& input) {
+    graph::Builder builder(root);
+    Evaluator evaluator;
+    builder.Register(evaluator);
+
+    auto file = Loader::Parse(root + "/src/BUILD.shi", input);
+    Scope scope;
+    evaluator.Execute(file->root.get(), scope);
+    return builder.Build();
+  }
+
+  String Read(const Path& path) {
+    std::ifstream stream(root + "/out/" + path);
+    std::stringstream contents;
+    contents << stream.rdbuf();
+    return contents.str();
+  }
+
+  Path root;
+};
+
+TEST_F(NinjaWriterTest, WriteTargets) {
+  auto graph = Build(
+      "executable(\"app\") {\n"
+      "  sources = [ \"main.cc\", \"util.h\" ]\n"
+      "  deps = [ \":lib\" ]\n"
+      "  libs = [ \"pthread\" ]\n"
+      "}\n"
+      "static_library(\"lib\") {\n"
+      "  sources = [ \"lib.c\" ]\n"
+      "  deps = [ \":set\" ]\n"
+      "  defines = [ \"NAME=a b\", \"DEBUG\" ]\n"
+      "  include_dirs = [ \"include\", \"//common\", \"/usr/include\" ]\n"
+      "}\n"
+      "source_set(\"set\") {\n"
+      "  sources = [ \"//common/set one.cc\" ]\n"
+      "}\n");
+
+  NinjaWriter::Options options;
+  options.source_root = root;
+  options.build_dir = root + "/out";
+
+  ThreadPool pool(4);
+  EXPECT_EQ(4u, NinjaWriter(*graph, options).Write(pool));
+
+  const auto build_file = Read("build.ninja");
+  EXPECT_NE(String::npos, build_file.find("subninja obj/src/app.ninja\n"));
+  EXPECT_NE(String::npos, build_file.find("build src$:app: phony app\n"));
+  EXPECT_NE(String::npos, build_file.find("\ndefault all\n"));
+
+  const auto app = Read("obj/src/app.ninja");
+  EXPECT_NE(String::npos, app.find("libs = -lpthread\n"));
+  EXPECT_NE(String::npos,
+            app.find("build obj/src/app.main.o: cxx ../src/main.cc || "
+                     "obj/src/liblib.a\n"));
+  EXPECT_NE(String::npos,
+            app.find("build app: link obj/src/app.main.o obj/src/liblib.a "
+                     "obj/common/set.set$ one.o || obj/src/liblib.a\n"));
+
+  const auto lib = Read("obj/src/lib.ninja");
+  EXPECT_NE(String::npos, lib.find("defines = '-DNAME=a b' -DDEBUG\n"));
+  EXPECT_NE(String::npos,
+            lib.find("include_dirs = -I../src/include -I../common "
+                     "-I/usr/include\n"));
+  EXPECT_NE(String::npos, lib.find("build obj/src/lib.lib.o: cc ../src/lib.c"));
+
+  const auto set = Read("obj/src/set.ninja");
+  EXPECT_NE(String::npos,
+            set.find("build obj/common/set.set$ one.o: cxx "
+                     "../common/set$ one.cc\n"));
+
+  // Nothing changed - nothing is written.
+  struct stat before, after;
+  ASSERT_EQ(0, stat((root + "/out/build.ninja").c_str(), &before));
+  EXPECT_EQ(0u, NinjaWriter(*graph, options).Write(pool));
+  ASSERT_EQ(0, stat((root + "/out/build.ninja").c_str(), &after));
+  EXPECT_EQ(before.st_mtim.tv_nsec, after.st_mtim.tv_nsec);
+  EXPECT_EQ(before.st_ino, after.st_ino);
+}
+
+TEST_F(NinjaWriterTest, SameNameSources) {
+  auto graph = Build(
+      "source_set(\"set\") {\n"
+      "  sources = [ \"a/foo.cc\", \"b/foo.cc\", \"foo.cc\" ]\n"
+      "}\n");
+
+  NinjaWriter::Options options;
+  options.source_root = root;
+  options.build_dir = root + "/out";
+
+  ThreadPool pool(4);
+  NinjaWriter(*graph, options).Write(pool);
+
+  const auto set = Read("obj/src/set.ninja");
+  EXPECT_NE(String::npos,
+            set.find("build obj/src/a/set.foo.o: cxx ../src/a/foo.cc\n"));
+  EXPECT_NE(String::npos,
+            set.find("build obj/src/b/set.foo.o: cxx ../src/b/foo.cc\n"));
+  EXPECT_NE(String::npos,
+            set.find("build obj/src/set.foo.o: cxx ../src/foo.cc\n"));
+}
+
+TEST_F(NinjaWriterTest, LinkOrder) {
+  // A diamond: each library goes before all of its deps.
+  auto graph = Build(
+      "executable(\"app\") {\n"
+      "  deps = [ \":a\", \":b\" ]\n"
+      "}\n"
+      "static_library(\"a\") {\n"
+      "  deps = [ \":c\" ]\n"
+      "}\n"
+      "static_library(\"b\") {\n"
+      "  deps = [ \":c\" ]\n"
+      "}\n"
+      "static_library(\"c\") {\n"
+      "}\n");
+
+  NinjaWriter::Options options;
+  options.source_root = root;
+  options.build_dir = root + "/out";
+
+  ThreadPool pool(4);
+  NinjaWriter(*graph, options).Write(pool);
+
+  EXPECT_NE(String::npos,
+            Read("obj/src/app.ninja")
+                .find("build app: link obj/src/liba.a obj/src/libb.a "
+                      "obj/src/libc.a ||"));
+}
+
+}  // namespace shinobi::output
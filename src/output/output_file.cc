@@ -0,0 +1,122 @@
+#include <output/output_file.hh>
+
+#include STL(algorithm)
+#include STL(cstring)
+#include STL(system_error)
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shinobi::output {
+
+namespace {
+
+constexpr size_t kChunkSize = 1024 * 1024;
+
+[[noreturn]] void ThrowError(const String& what, const Path& path) {
+  throw std::system_error(errno, std::generic_category(), what + " " + path);
+}
+
+}  // namespace
+
+OutputFile::OutputFile(const Path& file_path, size_t reserve)
+    : path_(file_path) {
+  contents_.reserve(reserve);
+}
+
+bool OutputFile::Commit() {
+  if (IsUnchanged()) {
+    return false;
+  }
+
+  const auto slash = path_.rfind('/');
+  if (slash != Path::npos && slash > 0) {
+    CreateDirectories(path_.substr(0, slash));
+  }
+
+  const Path temp_path = path_ + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                0644);
+  if (fd == -1) {
+    ThrowError("Failed to create", temp_path);
+  }
+
+  for (size_t written = 0; written < contents_.size();) {
+    auto size = std::min(kChunkSize, contents_.size() - written);
+    auto result = write(fd, contents_.data() + written, size);
+    if (result == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      unlink(temp_path.c_str());
+      ThrowError("Failed to write", temp_path);
+    }
+    written += result;
+  }
+
+  if (close(fd) == -1) {
+    unlink(temp_path.c_str());
+    ThrowError("Failed to close", temp_path);
+  }
+
+  if (rename(temp_path.c_str(), path_.c_str()) == -1) {
+    unlink(temp_path.c_str());
+    ThrowError("Failed to rename", temp_path);
+  }
+
+  return true;
+}
+
+// static
+void OutputFile::CreateDirectories(const Path& dir_path) {
+  struct stat info;
+  if (dir_path.empty() || stat(dir_path.c_str(), &info) == 0) {
+    return;
+  }
+
+  const auto slash = dir_path.rfind('/');
+  if (slash != Path::npos && slash > 0) {
+    CreateDirectories(dir_path.substr(0, slash));
+  }
+
+  if (mkdir(dir_path.c_str(), 0755) == -1 && errno != EEXIST) {
+    ThrowError("Failed to create directory", dir_path);
+  }
+}
+
+bool OutputFile::IsUnchanged() const {
+  int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) == -1 ||
+      static_cast<size_t>(info.st_size) != contents_.size()) {
+    close(fd);
+    return false;
+  }
+
+  UniquePtr<char[]> buffer(new char[kChunkSize]);
+  bool unchanged = true;
+  for (size_t offset = 0; unchanged && offset < contents_.size();) {
+    auto size = read(fd, buffer.get(), kChunkSize);
+    if (size == -1 && errno == EINTR) {
+      continue;
+    }
+    if (size <= 0) {
+      unchanged = false;
+      break;
+    }
+    unchanged = static_cast<size_t>(size) <= contents_.size() - offset &&
+                std::memcmp(buffer.get(), contents_.data() + offset, size) == 0;
+    offset += size;
+  }
+
+  close(fd);
+  return unchanged;
+}
+
+}  // namespace shinobi::output
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/path.hh>
+
+namespace shinobi::output {
+
+// Accumulates the whole contents in memory and writes it with a few large
+// writes into a temporary file, that is then renamed over the target file.
+// The file isn't touched at all, if the contents didn't change - to not bump
+// the modification time, that Ninja relies on.
+class OutputFile {
+ public:
+  explicit OutputFile(const Path& file_path, size_t reserve = 64 * 1024);
+
+  inline OutputFile& operator<<(const String& str) {
+    contents_.append(str);
+    return *this;
+  }
+  inline OutputFile& operator<<(const char* str) {
+    contents_.append(str);
+    return *this;
+  }
+  inline OutputFile& operator<<(char c) {
+    contents_.push_back(c);
+    return *this;
+  }
+
+  // For the functions that append to strings, like escaping.
+  inline String& contents() { return contents_; }
+  inline const Path& file_path() const { return path_; }
+
+  // Returns true if the file was actually written. Creates the missing parent
+  // directories. Throws |std::system_error|.
+  bool Commit();
+
+  // Creates the directory with all the missing parents.
+  static void CreateDirectories(const Path& dir_path);
+
+ private:
+  bool IsUnchanged() const;
+
+  const Path path_;
+  String contents_;
+};
+
+}  // namespace shinobi::output
@@ -0,0 +1,17 @@
+#include <output/variables.hh>
+
+namespace shinobi::output {
+
+using language::shi::Value;
+
+const Value::Items& GetList(const graph::Target& target, const String& name) {
+  static const Value::Items empty;
+
+  auto it = target.variables().find(name);
+  if (it == target.variables().end() || it->second.type() != Value::LIST) {
+    return empty;
+  }
+  return it->second.list();
+}
+
+}  // namespace shinobi::output
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <graph/target.hh>
+
+namespace shinobi::output {
+
+// Returns the list variable of the target, like "sources" - or an empty list,
+// if it isn't set or isn't a list.
+const language::shi::Value::Items& GetList(const graph::Target& target,
+                                           const String& name);
+
+}  // namespace shinobi::output
@@ -0,0 +1,125 @@
+#include <base/aliases.hh>
+#include <base/logging.hh>
+#include <language/shi/evaluator.hh>
+#include <language/shi/loader.hh>
+#include <language/shi/optimizer.hh>
+
+// Third-party
+#include <gflags/gflags.h>
+
+#include STL(algorithm)
+#include STL(chrono)
+#include STL(iomanip)
+#include STL(iostream)
+
+#include <base/using_log.hh>
+
+namespace shinobi {
+
+DEFINE_uint32(targets, 2000, "Number of targets in the generated file");
+DEFINE_uint32(iterations, 20, "Number of measured iterations");
+
+namespace {
+
+using namespace language::shi;
+using Clock = std::chrono::steady_clock;
+
+// A build file, that exercises all kinds of nodes.
+String GenerateBuildFile(ui32 targets) {
+  String contents = "is_debug = false\nflags = [ \"-Wall\" ]\n";
+  for (ui32 i = 0; i < targets; ++i) {
+    const String name = "target_" + std::to_string(i);
+    contents += "# Target number " + std::to_string(i) + "\n";
+    contents += "source_set(\"" + name + "\") {\n";
+    contents += "  sources = [ \"" + name + ".cc\", \"" + name + ".hh\" ]\n";
+    contents += "  cflags = flags\n";
+    contents += "  if (is_debug && !(" + std::to_string(i) + " > 10)) {\n";
+    contents += "    cflags += [ \"-O0\" ]\n";
+    contents += "  } else {\n";
+    contents += "    cflags -= [ \"-Wall\" ]\n";
+    contents += "  }\n";
+    if (i > 0) {
+      contents += "  deps = [ \":target_" + std::to_string(i - 1) + "\" ]\n";
+    }
+    contents += "}\n";
+  }
+  return contents;
+}
+
+struct Timing {
+  void Add(Clock::duration duration) {
+    const double ms =
+        std::chrono::duration<double, std::milli>(duration).count();
+    best = samples ? std::min(best, ms) : ms;
+    total += ms;
+    ++samples;
+  }
+
+  double best = 0, total = 0;
+  ui32 samples = 0;
+};
+
+void Print(const char* phase, const Timing& timing, size_t bytes) {
+  std::cout << std::left << std::setw(12) << phase << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << timing.best
+            << " ms best" << std::setw(10) << timing.total / timing.samples
+            << " ms avg" << std::setw(10)
+            << bytes / 1048576.0 / (timing.best / 1000) << " MB/s\n";
+}
+
+}  // namespace
+
+}  // namespace shinobi
+
+int main(int argc, char* argv[]) {
+  using namespace shinobi;
+  using namespace shinobi::language::shi;
+
+  gflags::SetUsageMessage(
+      "Measures lexing, parsing, optimization and evaluation of a generated "
+      "build file");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  Log::Reset(named_levels::ERROR,
+             {std::make_pair(named_levels::INFO, named_levels::FATAL)});
+
+  const String contents = GenerateBuildFile(FLAGS_targets);
+
+  Evaluator evaluator;
+  evaluator.RegisterFunction(
+      "source_set", [](Scope&, const CallNode*, Vector<Value>&, Scope*) {
+        return Value();
+      });
+  const Optimizer optimizer({{"is_debug", Value(false)}});
+
+  Timing parse, optimize, evaluate;
+  try {
+    // The first iteration warms up the caches and isn't measured.
+    for (ui32 i = 0; i <= FLAGS_iterations; ++i) {
+      auto begin = Clock::now();
+      auto file = Loader::Parse("//BUILD.shi", contents);
+      auto parsed = Clock::now();
+      auto tree = optimizer.Optimize(file->root.get());
+      auto optimized = Clock::now();
+      Scope scope;
+      evaluator.Execute(file->root.get(), scope);
+      auto evaluated = Clock::now();
+
+      if (i > 0) {
+        parse.Add(parsed - begin);
+        optimize.Add(optimized - parsed);
+        evaluate.Add(evaluated - optimized);
+      }
+    }
+  } catch (const std::exception& error) {
+    LOG(ERROR) << error.what();
+    return 1;
+  }
+
+  std::cout << FLAGS_targets << " targets, " << contents.size() << " bytes, "
+            << FLAGS_iterations << " iterations\n";
+  Print("parse", parse, contents.size());
+  Print("optimize", optimize, contents.size());
+  Print("evaluate", evaluate, contents.size());
+  return 0;
+}
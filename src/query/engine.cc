@@ -0,0 +1,192 @@
+#include <query/engine.hh>
+
+#include <base/stats.hh>
+#include <base/tracing.hh>
+
+#include STL(algorithm)
+
+namespace shinobi::query {
+
+using namespace language::shi;
+
+namespace {
+
+const Stats::Counter queries_run("query.queries");
+const Stats::Counter index_time("time.build_query_index",
+                                Stats::MICROSECONDS);
+
+String PrintLocation(const Location& location) {
+  return location.file_path() + ":" + std::to_string(location.line()) + ":" +
+         std::to_string(location.column());
+}
+
+}  // namespace
+
+QueryError::QueryError(const String& error_message)
+    : message_(error_message) {}
+
+const char* QueryError::what() const noexcept {
+  return message_.c_str();
+}
+
+Engine::Engine(const graph::Graph& graph, const Vector<Loader::FilePtr>& files)
+    : graph_(graph) {
+  Tracing::Span span("Engine::Build");
+  Stats::Timer timer(index_time);
+
+  for (Index i = 0; i < graph_.size(); ++i) {
+    const auto& target = graph_.target(i);
+    for (const char* name : {"sources", "public"}) {
+      auto it = target.variables().find(name);
+      if (it == target.variables().end() || it->second.type() != Value::LIST) {
+        continue;
+      }
+
+      for (const auto& item : it->second.list()) {
+        Path path;
+        if (item.type() != Value::STRING ||
+            !ResolvePath(item.string(), target.label().dir(), path)) {
+          continue;
+        }
+
+        // The same file may be listed in both.
+        auto& owners = owners_[path];
+        if (owners.empty() || owners.back() != i) {
+          owners.push_back(i);
+        }
+      }
+    }
+  }
+
+  for (const auto& file : files) {
+    IndexAssignments(file->root.get());
+  }
+}
+
+Vector<String> Engine::Run(const String& query) const {
+  queries_run.Add();
+
+  const auto space = query.find(' ');
+  const auto kind = query.substr(0, space);
+  const auto argument =
+      space == String::npos ? String() : query.substr(space + 1);
+  if (argument.empty()) {
+    throw QueryError("Invalid query: " + query);
+  }
+
+  Vector<String> results;
+  if (kind == "rdeps") {
+    Label label;
+    Index index;
+    if (!Label::Parse(argument, "//", label) || !graph_.Find(label, index)) {
+      throw QueryError("Unknown target: " + argument);
+    }
+    for (auto dependent : Dependents(index)) {
+      results.push_back(graph_.target(dependent).label().ToString());
+    }
+  } else if (kind == "owners") {
+    for (auto owner : Owners(argument)) {
+      results.push_back(graph_.target(owner).label().ToString());
+    }
+  } else if (kind == "refs") {
+    for (const auto& location : Assignments(argument)) {
+      results.push_back(PrintLocation(location));
+    }
+  } else {
+    throw QueryError("Unknown query: " + kind);
+  }
+
+  return results;
+}
+
+Vector<Engine::Index> Engine::Dependents(Index index) const {
+  Vector<bool> visited(graph_.size());
+  Vector<Index> result, queue = {index};
+  visited[index] = true;
+
+  while (!queue.empty()) {
+    const auto next = queue.back();
+    queue.pop_back();
+    for (auto dependent : graph_.dependents(next)) {
+      if (!visited[dependent]) {
+        visited[dependent] = true;
+        result.push_back(dependent);
+        queue.push_back(dependent);
+      }
+    }
+  }
+
+  std::sort(result.begin(), result.end(), [this](Index a, Index b) {
+    return graph_.target(a).label() < graph_.target(b).label();
+  });
+  return result;
+}
+
+Vector<Engine::Index> Engine::Owners(const Path& file_path) const {
+  Path path;
+  if (!ResolvePath(file_path, "//", path)) {
+    return {};
+  }
+
+  auto it = owners_.find(path);
+  if (it == owners_.end()) {
+    return {};
+  }
+
+  auto result = it->second;
+  std::sort(result.begin(), result.end(), [this](Index a, Index b) {
+    return graph_.target(a).label() < graph_.target(b).label();
+  });
+  return result;
+}
+
+const Vector<Location>& Engine::Assignments(const String& name) const {
+  static const Vector<Location> empty;
+
+  auto it = assignments_.find(name);
+  return it == assignments_.end() ? empty : it->second;
+}
+
+void Engine::IndexAssignments(const Node* node) {
+  if (!node) {
+    return;
+  }
+
+  switch (node->type()) {
+    case Node::STATEMENT_LIST:
+      for (const auto& statement : *node->asStatementList()) {
+        IndexAssignments(statement.get());
+      }
+      break;
+
+    case Node::CONDITION:
+      IndexAssignments(node->asCondition()->if_block());
+      IndexAssignments(node->asCondition()->else_statement());
+      break;
+
+    case Node::CALL:
+      IndexAssignments(node->asCall()->block());
+      break;
+
+    case Node::ASSIGNMENT: {
+      const auto* lvalue = node->asAssignment()->left_value();
+      const Token* id = nullptr;
+      if (lvalue->type() == Node::IDENTIFIER) {
+        id = &lvalue->asIdentifier()->identifier();
+      } else if (lvalue->type() == Node::ARRAY_ACCESS) {
+        id = &lvalue->asArrayAccess()->identifier();
+      } else if (lvalue->type() == Node::SCOPE_ACCESS) {
+        id = &lvalue->asScopeAccess()->identifier();
+      }
+      if (id) {
+        assignments_[id->value()].push_back(id->location());
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+}  // namespace shinobi::query
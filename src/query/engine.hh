@@ -0,0 +1,53 @@
+#pragma once
+
+#include <graph/graph.hh>
+#include <language/shi/loader.hh>
+
+namespace shinobi::query {
+
+class QueryError : public std::exception {
+ public:
+  explicit QueryError(const String& error_message);
+  const char* what() const noexcept override;
+
+ private:
+  String message_;
+};
+
+// Answers the questions about the evaluated build with the indices, prebuilt
+// once for the graph and the build files - each answer costs a hash lookup and
+// the size of the result:
+//
+//   rdeps <label>  - the targets, that depend on the target, transitively;
+//   owners <file>  - the targets, that list the file in "sources" or "public";
+//   refs <name>    - the assignments of the variable in the build files.
+//
+// The labels and the files are relative to the source root, like "//src:app"
+// or "//src/main.cc". The graph and the files should outlive the engine.
+class Engine {
+ public:
+  using Index = graph::Graph::Index;
+
+  Engine(const graph::Graph& graph,
+         const Vector<language::shi::Loader::FilePtr>& files);
+
+  // Returns the sorted results - as text. Throws |QueryError| on unknown
+  // queries or targets.
+  THREAD_SAFE Vector<String> Run(const String& query) const;
+
+  // The results are sorted by label.
+  THREAD_SAFE Vector<Index> Dependents(Index index) const;
+  THREAD_SAFE Vector<Index> Owners(const Path& file_path) const;
+
+  // The results are in the order of the files, then of the statements.
+  THREAD_SAFE const Vector<Location>& Assignments(const String& name) const;
+
+ private:
+  void IndexAssignments(const language::shi::Node* node);
+
+  const graph::Graph& graph_;
+  Map<Path, Vector<Index>> owners_;  // By the source-absolute path.
+  Map<String, Vector<Location>> assignments_;
+};
+
+}  // namespace shinobi::query
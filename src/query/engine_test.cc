@@ -0,0 +1,85 @@
+#include <graph/builder.hh>
+#include <language/shi/loader.hh>
+#include <query/engine.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+namespace shinobi::query {
+
+using namespace language::shi;
+
+class EngineTest : public ::testing::Test {
+ protected:
+  void Evaluate(const Path& file_path, const String& input) {
+    files.push_back(Loader::Parse(file_path, input));
+    Scope scope;
+    evaluator.Execute(files.back()->root.get(), scope);
+  }
+
+  void SetUp() override {
+    builder.Register(evaluator);
+
+    Evaluate("/root/src/BUILD.shi",
+             "common = [ \"-W\" ]\n"
+             "executable(\"app\") {\n"
+             "  sources = [ \"main.cc\" ]\n"
+             "  deps = [ \":lib\" ]\n"
+             "}\n"
+             "static_library(\"lib\") {\n"
+             "  sources = [ \"lib.cc\", \"base/shared.hh\" ]\n"
+             "  public = [ \"base/shared.hh\" ]\n"
+             "  deps = [ \"//src/base\" ]\n"
+             "  if (true) {\n"
+             "    common += [ \"-O2\" ]\n"
+             "  }\n"
+             "}\n");
+    Evaluate("/root/src/base/BUILD.shi",
+             "source_set(\"base\") {\n"
+             "  sources = [ \"shared.hh\", \"base.cc\" ]\n"
+             "}\n"
+             "group(\"tools\") {\n"
+             "  deps = [ \":base\" ]\n"
+             "}\n");
+
+    graph = builder.Build();
+    engine = std::make_unique<Engine>(*graph, files);
+  }
+
+  graph::Builder builder{"/root"};
+  Evaluator evaluator;
+  Vector<Loader::FilePtr> files;
+  UniquePtr<graph::Graph> graph;
+  UniquePtr<Engine> engine;
+};
+
+TEST_F(EngineTest, Dependents) {
+  EXPECT_EQ(Vector<String>({"//src/base:tools", "//src:app", "//src:lib"}),
+            engine->Run("rdeps //src/base"));
+  EXPECT_EQ(Vector<String>({"//src:app"}), engine->Run("rdeps //src:lib"));
+  EXPECT_TRUE(engine->Run("rdeps //src:app").empty());
+  EXPECT_THROW(engine->Run("rdeps //src:unknown"), QueryError);
+}
+
+TEST_F(EngineTest, Owners) {
+  EXPECT_EQ(Vector<String>({"//src/base:base", "//src:lib"}),
+            engine->Run("owners //src/base/shared.hh"));
+  EXPECT_EQ(Vector<String>({"//src:app"}),
+            engine->Run("owners //src/./main.cc"));
+  EXPECT_TRUE(engine->Run("owners //src/unknown.cc").empty());
+}
+
+TEST_F(EngineTest, Assignments) {
+  EXPECT_EQ(Vector<String>({"/root/src/BUILD.shi:1:1",
+                            "/root/src/BUILD.shi:11:5"}),
+            engine->Run("refs common"));
+  EXPECT_EQ(3u, engine->Assignments("sources").size());
+  EXPECT_TRUE(engine->Run("refs unknown").empty());
+}
+
+TEST_F(EngineTest, InvalidQueries) {
+  EXPECT_THROW(engine->Run("rdeps"), QueryError);
+  EXPECT_THROW(engine->Run("who //src:app"), QueryError);
+}
+
+}  // namespace shinobi::query
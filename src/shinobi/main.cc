@@ -0,0 +1,228 @@
+#include <base/aliases.hh>
+#include <base/crash.hh>
+#include <base/logging.hh>
+#include <base/memory.hh>
+#include <base/stats.hh>
+#include <base/tracing.hh>
+#include <daemon/client.hh>
+#include <daemon/server.hh>
+
+// Third-party
+#include <gflags/gflags.h>
+
+#include STL(fstream)
+#include STL(iostream)
+
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <base/using_log.hh>
+
+namespace shinobi {
+
+DEFINE_string(root, ".", "Path to the source root");
+DEFINE_string(build_config, "//build/config/BUILDCONFIG.shi",
+              "Path to the build config, executed before any build file");
+DEFINE_uint32(threads, 0, "Number of worker threads, 0 - number of cores");
+DEFINE_string(trace, String(),
+              "Path to write the Chrome trace-event JSON of this run");
+DEFINE_string(stats, String(),
+              "Print the run statistics to stderr in the given format: table "
+              "or json");
+DEFINE_string(memory, String(),
+              "Print the memory usage by owner, phase and file to stderr in "
+              "the given format: table or json - in the builds with "
+              "config_memory_accounting");
+DEFINE_string(crash_report, String(),
+              "Path to append the raw crash reports to, instead of stderr");
+DEFINE_string(symbolize, String(),
+              "Symbolize the crash report written by this binary and exit");
+DEFINE_bool(check, false,
+            "Check that the sources include only the headers of their own "
+            "targets and the public headers of their deps");
+DEFINE_bool(export_compile_commands, false,
+            "Also write the compile_commands.json to each build directory");
+DEFINE_string(query, String(),
+              "Print the results of the queries, separated by \";\": "
+              "\"rdeps <label>\", \"owners <file>\" or \"refs <variable>\" "
+              "- e.g. \"rdeps //src/base;owners //src/base/file.cc\"");
+DEFINE_bool(daemon, false,
+            "Stay resident: watch the source tree and serve the runs of the "
+            "clients - the later runs with the same root - over a Unix socket");
+DEFINE_string(socket, String(),
+              "Path to the socket of the daemon, by default "
+              "<root>/.shinobi_daemon");
+
+namespace {
+
+constexpr const char* kSocketName = ".shinobi_daemon";
+
+Path AbsolutePath(const Path& path) {
+  char buffer[PATH_MAX];
+  if (!realpath(path.c_str(), buffer)) {
+    return path;
+  }
+  return buffer;
+}
+
+Path WorkingDir() {
+  char buffer[PATH_MAX];
+  if (!getcwd(buffer, sizeof(buffer))) {
+    return ".";
+  }
+  return buffer;
+}
+
+daemon::Server* running_server = nullptr;
+
+void StopServer(int) {
+  running_server->Stop();
+}
+
+}  // namespace
+
+}  // namespace shinobi
+
+int main(int argc, char* argv[]) {
+  using namespace shinobi;
+
+  gflags::SetUsageMessage(
+      "Generates Ninja files for each configuration:\n\n"
+      "  shinobi [flags] <build_dir>[:<args>] ...\n\n"
+      "e.g. shinobi //out/Debug:\"is_debug=true\" //out/Release\n\n"
+      "The runs are served by the resident daemon of the same root, if "
+      "any:\n\n"
+      "  shinobi --daemon [--root=<dir>]");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Before anything, that may log.
+  Log::Reset(named_levels::ERROR,
+             {std::make_pair(named_levels::INFO, named_levels::FATAL)});
+  Log::SetAsync(true);
+
+  if (!FLAGS_symbolize.empty()) {
+    std::ifstream report(FLAGS_symbolize);
+    return Crash::Symbolize(report, std::cout) ? 0 : 1;
+  }
+  if (!Crash::Install(FLAGS_crash_report)) {
+    LOG(ERROR) << "Failed to open the crash report " << FLAGS_crash_report;
+    return 1;
+  }
+
+  if (!FLAGS_trace.empty()) {
+    Tracing::Enable();
+  }
+  if (!FLAGS_stats.empty()) {
+    if (FLAGS_stats != "table" && FLAGS_stats != "json") {
+      LOG(ERROR) << "Unknown statistics format: " << FLAGS_stats;
+      return 1;
+    }
+    Stats::Enable();
+  }
+  if (!FLAGS_memory.empty()) {
+    if (FLAGS_memory != "table" && FLAGS_memory != "json") {
+      LOG(ERROR) << "Unknown memory usage format: " << FLAGS_memory;
+      return 1;
+    }
+    if (!Memory::Enable()) {
+      LOG(ERROR) << "The memory accounting isn't built in - see "
+                    "config_memory_accounting";
+      return 1;
+    }
+  }
+
+  const Path source_root = AbsolutePath(FLAGS_root);
+  const Path socket_path =
+      FLAGS_socket.empty() ? source_root + "/" + kSocketName : FLAGS_socket;
+  int result = 0;
+
+  if (FLAGS_daemon) {
+    daemon::Generator generator(source_root, FLAGS_threads);
+    daemon::Watcher watcher(daemon::Generator::kDatabaseName);
+    daemon::Server server(generator, watcher);
+    if (!watcher.Watch(source_root)) {
+      LOG(ERROR) << "Failed to watch " << source_root;
+      return 1;
+    }
+    if (!server.Listen(socket_path)) {
+      LOG(ERROR) << "Failed to listen on " << socket_path;
+      return 1;
+    }
+
+    running_server = &server;
+    signal(SIGINT, StopServer);
+    signal(SIGTERM, StopServer);
+
+    LOG(INFO) << "Serving " << source_root << " on " << socket_path;
+    server.Serve();
+    running_server = nullptr;
+  } else {
+    if (argc < 2) {
+      LOG(ERROR) << "No build directories specified";
+      return 1;
+    }
+
+    daemon::Generator::Request request;
+    request.working_dir = WorkingDir();
+    request.build_config = FLAGS_build_config;
+    request.arguments.assign(argv + 1, argv + argc);
+    request.check_headers = FLAGS_check;
+    request.export_compile_commands = FLAGS_export_compile_commands;
+    for (size_t begin = 0; begin < FLAGS_query.size();) {
+      auto end = FLAGS_query.find(';', begin);
+      if (end == String::npos) {
+        end = FLAGS_query.size();
+      }
+      if (end > begin) {
+        request.queries.push_back(FLAGS_query.substr(begin, end - begin));
+      }
+      begin = end + 1;
+    }
+
+    // The statistics of the run are only available in-process.
+    const bool in_process =
+        !FLAGS_trace.empty() || !FLAGS_stats.empty() || !FLAGS_memory.empty();
+
+    bool success = true;
+    Vector<String> messages;
+    if (in_process ||
+        !daemon::Client::Run(socket_path, request, success, messages)) {
+      try {
+        messages = daemon::Generator(source_root, FLAGS_threads).Run(request);
+      } catch (const std::exception& error) {
+        success = false;
+        messages = {error.what()};
+      }
+    }
+
+    for (const auto& message : messages) {
+      if (success) {
+        LOG(INFO) << message;
+      } else {
+        LOG(ERROR) << message;
+      }
+    }
+    result = success ? 0 : 1;
+  }
+
+  if (!FLAGS_stats.empty()) {
+    Log::SetAsync(false);  // Don't interleave with the pending messages.
+    Stats::Print(std::cerr,
+                 FLAGS_stats == "json" ? Stats::JSON : Stats::TABLE);
+  }
+
+  if (!FLAGS_memory.empty()) {
+    Log::SetAsync(false);
+    Memory::Print(std::cerr,
+                  FLAGS_memory == "json" ? Stats::JSON : Stats::TABLE);
+  }
+
+  if (!FLAGS_trace.empty() && !Tracing::Write(FLAGS_trace)) {
+    LOG(ERROR) << "Failed to write trace to " << FLAGS_trace;
+    result = 1;
+  }
+
+  return result;
+}
@@ -0,0 +1,222 @@
+#include <synthetic/tree_generator.hh>
+
+#include <output/output_file.hh>
+
+#include STL(algorithm)
+
+namespace shinobi::synthetic {
+
+// SplitMix64 - unlike the standard distributions, gives the same numbers with
+// any standard library.
+class Random {
+ public:
+  explicit Random(ui64 seed) : state_(seed) {}
+
+  ui64 Next() {
+    ui64 z = (state_ += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  // In the range [0, size), which shouldn't be empty.
+  ui64 Below(ui64 size) { return Next() % size; }
+
+ private:
+  ui64 state_;
+};
+
+namespace {
+
+String FilePath(ui32 file) {
+  return "src/g" + std::to_string(file / 16) + "/d" + std::to_string(file);
+}
+
+String ImportPath(ui32 index) {
+  return "build/imports/import_" + std::to_string(index) + ".shi";
+}
+
+void AppendConditions(ui32 target, ui32 depth, ui32 max_depth,
+                      const String& indent, String& contents) {
+  if (depth == max_depth) {
+    return;
+  }
+
+  const auto level = std::to_string(depth);
+  const auto name = "T" + std::to_string(target) + "_LEVEL" + level;
+  contents += indent + "if (feature_level > " + level + ") {\n";
+  contents += indent + "  defines += [ \"" + name + "\" ]\n";
+  AppendConditions(target, depth + 1, max_depth, indent + "  ", contents);
+  contents += indent + "} else {\n";
+  contents += indent + "  cflags += [ \"-U" + name + "\" ]\n";
+  contents += indent + "}\n";
+}
+
+}  // namespace
+
+// static
+bool TreeGenerator::ParseShape(const String& name, Shape& shape) {
+  static const Pair<const char*, Shape> kShapes[] = {
+      {"chain", CHAIN},
+      {"tree", TREE},
+      {"layered", LAYERED},
+      {"random", RANDOM},
+  };
+
+  for (const auto& known : kShapes) {
+    if (name == known.first) {
+      shape = known.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+TreeGenerator::TreeGenerator(const Options& options) : options_(options) {}
+
+void TreeGenerator::Generate(
+    const std::function<void(const Path&, const String&)>& write) const {
+  write(Path(kBuildConfig).substr(2),
+        "# Generated by TreeGenerator.\n"
+        "declare_args() {\n"
+        "  is_debug = false\n"
+        "  feature_level = 1\n"
+        "}\n");
+
+  for (ui32 i = 0; i < options_.import_files; ++i) {
+    write(ImportPath(i), GenerateImport(i));
+  }
+
+  Random random(options_.seed);
+  for (ui32 i = 0; i < options_.files; ++i) {
+    write(FilePath(i) + "/BUILD.shi", GenerateBuildFile(i, random));
+  }
+}
+
+ui32 TreeGenerator::Write(const Path& root) const {
+  ui32 files = 0;
+  Generate([&root, &files](const Path& path, const String& contents) {
+    output::OutputFile file(root + "/" + path, contents.size());
+    file << contents;
+    file.Commit();
+    ++files;
+  });
+  return files;
+}
+
+String TreeGenerator::GenerateImport(ui32 index) const {
+  const auto name = std::to_string(index);
+  String contents = "# Shared flags " + name + ".\n";
+  if (index > 0) {
+    contents += "import(\"//" + ImportPath((index - 1) / 2) + "\")\n";
+  }
+
+  contents += "flags_" + name + " = [";
+  for (ui32 i = 0; i < options_.list_length; ++i) {
+    contents += " \"-DIMPORT_" + name + "_" + std::to_string(i) + "\",";
+  }
+  contents += " ]\n";
+  return contents;
+}
+
+String TreeGenerator::GenerateBuildFile(ui32 index, Random& random) const {
+  String contents = "# Generated by TreeGenerator.\n";
+
+  Vector<ui32> imports;
+  if (options_.import_files) {
+    for (ui32 i = 0; i < options_.imports_per_file; ++i) {
+      imports.push_back(random.Below(options_.import_files));
+    }
+    std::sort(imports.begin(), imports.end());
+    imports.erase(std::unique(imports.begin(), imports.end()), imports.end());
+  }
+  for (auto import : imports) {
+    contents += "import(\"//" + ImportPath(import) + "\")\n";
+  }
+
+  const ui64 first_target = ui64(index) * options_.targets_per_file;
+  for (ui32 i = 0; i < options_.targets_per_file; ++i) {
+    const ui64 target = first_target + i;
+    const auto name = "t" + std::to_string(i);
+
+    Vector<ui64> deps;
+    const ui32 count = std::max<ui32>(options_.deps_per_target, 1);
+    switch (options_.shape) {
+      case CHAIN:
+        if (target > 0) {
+          deps.push_back(target - 1);
+        }
+        break;
+      case TREE:
+        if (target > 0) {
+          deps.push_back((target - 1) / count);
+        }
+        break;
+      case LAYERED:
+        if (index > 0) {
+          const ui64 previous = first_target - options_.targets_per_file;
+          for (ui32 j = 0; j < options_.deps_per_target; ++j) {
+            deps.push_back(previous + random.Below(options_.targets_per_file));
+          }
+        }
+        break;
+      case RANDOM:
+        if (target > 0) {
+          for (ui32 j = 0; j < options_.deps_per_target; ++j) {
+            deps.push_back(random.Below(target));
+          }
+        }
+        break;
+    }
+    std::sort(deps.begin(), deps.end());
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+    contents += "\n";
+    // The last target links everything it depends on.
+    if (target + 1 == targets()) {
+      contents += "executable";
+    } else {
+      contents += i % 4 == 3 ? "static_library" : "source_set";
+    }
+    contents += "(\"" + name + "\") {\n";
+
+    contents += "  sources = [";
+    for (ui32 j = 0; j < options_.list_length; ++j) {
+      contents += " \"" + name + "_" + std::to_string(j) +
+                  (j % 2 ? ".hh\"," : ".cc\",");
+    }
+    contents += " ]\n";
+
+    contents += "  defines = [ \"T" + std::to_string(target) + "\" ]\n";
+    contents += "  cflags = [";
+    for (auto import : imports) {
+      contents += " \"-DUSES_" + std::to_string(import) + "\",";
+    }
+    contents += " ]\n";
+    for (auto import : imports) {
+      contents += "  cflags += flags_" + std::to_string(import) + "\n";
+    }
+
+    if (!deps.empty()) {
+      contents += "  deps = [";
+      for (auto dep : deps) {
+        contents += " \"" + TargetLabel(dep, index) + "\",";
+      }
+      contents += " ]\n";
+    }
+
+    AppendConditions(target, 0, options_.nesting_depth, "  ", contents);
+    contents += "}\n";
+  }
+
+  return contents;
+}
+
+String TreeGenerator::TargetLabel(ui64 target, ui32 file) const {
+  const ui32 target_file = target / options_.targets_per_file;
+  const auto name =
+      ":t" + std::to_string(target % options_.targets_per_file);
+  return target_file == file ? name : "//" + FilePath(target_file) + name;
+}
+
+}  // namespace shinobi::synthetic
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <base/aliases.hh>
+#include <base/path.hh>
+
+#include STL(functional)
+
+namespace shinobi::synthetic {
+
+class Random;
+
+// Generates a build tree of the given scale - for the benchmarks and the
+// stress tests. The same options give the same tree on any platform: the
+// random choices come from a seeded generator of our own.
+//
+// The tree consists of the build config, the shared imports - each importing
+// its parent, so they form a binary tree - and the build files like
+// "src/g0/d3/BUILD.shi". The deps of a target always point to the targets
+// generated before it, so the graph is acyclic for any shape. The last target
+// is an executable - the rest are the source sets and the static libraries.
+class TreeGenerator {
+ public:
+  static constexpr const char* kBuildConfig = "//build/config/BUILDCONFIG.shi";
+
+  enum Shape {
+    CHAIN,    // Each target depends on the previous one.
+    TREE,     // Each target depends on its parent - of |deps_per_target|
+              // children.
+    LAYERED,  // On random targets of the previous build file.
+    RANDOM,   // On random targets of all the previous ones.
+  };
+
+  struct Options {
+    ui64 seed = 1;
+    ui32 files = 100;
+    ui32 targets_per_file = 10;
+    ui32 list_length = 10;      // Of the sources and the flags.
+    ui32 nesting_depth = 2;     // Of the conditions in a target.
+    ui32 import_files = 10;
+    ui32 imports_per_file = 2;  // The average fan-in is |files| times this,
+                                // divided by |import_files|.
+    Shape shape = LAYERED;
+    ui32 deps_per_target = 3;
+  };
+
+  // Returns false for an unknown shape - the names are lowercase.
+  static bool ParseShape(const String& name, Shape& shape);
+
+  explicit TreeGenerator(const Options& options);
+
+  // Calls the |write| for each file, with its path relative to the source
+  // root, in a deterministic order.
+  void Generate(
+      const std::function<void(const Path&, const String&)>& write) const;
+
+  // Writes the tree under the |root|. The unchanged files aren't touched.
+  // Returns the number of the files. Throws |std::system_error|.
+  ui32 Write(const Path& root) const;
+
+  inline ui64 targets() const {
+    return ui64(options_.files) * options_.targets_per_file;
+  }
+
+ private:
+  String GenerateImport(ui32 index) const;
+  String GenerateBuildFile(ui32 index, Random& random) const;
+
+  // Returns the label of the target by its global index, relative to the file
+  // if it's in the same one.
+  String TargetLabel(ui64 target, ui32 file) const;
+
+  const Options options_;
+};
+
+}  // namespace shinobi::synthetic
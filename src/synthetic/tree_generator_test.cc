@@ -0,0 +1,124 @@
+#include <base/file_system.hh>
+#include <base/memory.hh>
+#include <daemon/generator.hh>
+#include <synthetic/tree_generator.hh>
+
+// Third-party
+#include <gtest/gtest.h>
+
+#include STL(fstream)
+#include STL(sstream)
+
+#include <stdlib.h>
+
+namespace shinobi::synthetic {
+
+namespace {
+
+Map<Path, String> Generate(const TreeGenerator::Options& options) {
+  Map<Path, String> files;
+  TreeGenerator(options).Generate(
+      [&files](const Path& path, const String& contents) {
+        EXPECT_TRUE(files.emplace(path, contents).second) << path;
+      });
+  return files;
+}
+
+}  // namespace
+
+class TreeGeneratorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char temp_dir[] = "/tmp/tree_generator_test-XXXXXX";
+    ASSERT_TRUE(mkdtemp(temp_dir));
+    root = temp_dir;
+  }
+
+  void TearDown() override {
+    Memory::Disable();
+    FileSystem::InvalidateAll();
+    ASSERT_EQ(0, system(("rm -rf " + root).c_str()));
+  }
+
+  Path root;
+};
+
+TEST_F(TreeGeneratorTest, Deterministic) {
+  TreeGenerator::Options options;
+  options.files = 20;
+  options.shape = TreeGenerator::RANDOM;
+
+  const auto files = Generate(options);
+  EXPECT_EQ(1u + options.import_files + options.files, files.size());
+  EXPECT_EQ(files, Generate(options));
+
+  options.seed = 2;
+  EXPECT_NE(files, Generate(options));
+}
+
+TEST_F(TreeGeneratorTest, ParseShape) {
+  TreeGenerator::Shape shape;
+  EXPECT_TRUE(TreeGenerator::ParseShape("tree", shape));
+  EXPECT_EQ(TreeGenerator::TREE, shape);
+  EXPECT_FALSE(TreeGenerator::ParseShape("Tree", shape));
+}
+
+// Runs the whole generator over the trees of every shape.
+TEST_F(TreeGeneratorTest, Evaluates) {
+  for (auto shape : {TreeGenerator::CHAIN, TreeGenerator::TREE,
+                     TreeGenerator::LAYERED, TreeGenerator::RANDOM}) {
+    const Path shape_root = root + "/" + std::to_string(shape);
+
+    TreeGenerator::Options options;
+    options.files = 40;
+    options.targets_per_file = 5;
+    options.nesting_depth = 3;
+    options.import_files = 7;
+    options.shape = shape;
+    const TreeGenerator generator(options);
+    EXPECT_EQ(48u, generator.Write(shape_root));
+
+    daemon::Generator::Request request;
+    request.working_dir = shape_root;
+    request.build_config = TreeGenerator::kBuildConfig;
+    request.arguments = {"//out:feature_level=2"};
+
+    const auto summary = daemon::Generator(shape_root, 4).Run(request);
+    ASSERT_EQ(1u, summary.size());
+    EXPECT_EQ(0u, summary[0].find("Generated " +
+                                  std::to_string(generator.targets()) +
+                                  " targets"))
+        << summary[0];
+  }
+}
+
+// The memory of the generation should stay linear in the number of targets -
+// e.g. the link inputs shouldn't be copied into each dependent.
+TEST_F(TreeGeneratorTest, Scales) {
+  TreeGenerator::Options options;
+  options.files = 300;
+  options.shape = TreeGenerator::RANDOM;
+  const TreeGenerator generator(options);
+  generator.Write(root);
+
+  daemon::Generator::Request request;
+  request.working_dir = root;
+  request.build_config = TreeGenerator::kBuildConfig;
+  request.arguments = {"//out"};
+
+  ASSERT_TRUE(Memory::Enable());
+  const auto before = Memory::Get(Memory::OUTPUT).peak;
+  daemon::Generator(root, 4).Run(request);
+  EXPECT_LT(Memory::Get(Memory::OUTPUT).peak - before, 64 << 20);
+
+  // The executable links the objects of all its transitive deps.
+  std::ifstream stream(root + "/out/obj/src/g18/d299/t9.ninja");
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  const auto link = contents.str().find("build t9: link ");
+  ASSERT_NE(String::npos, link);
+  EXPECT_NE(String::npos, contents.str().find(" obj/src/g0/d0/t0.t0_0.o",
+                                               link));
+}
+
+}  // namespace shinobi::synthetic